@@ -0,0 +1,69 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// Runs a pipeline with the sample tracers of tracers.h and prints their
+// reports.
+
+#include <gstreamermm.h>
+#include <iostream>
+#include "tracers.h"
+
+int main(int argc, char** argv)
+{
+  Gst::init(argc, argv);
+
+  // The tracers observe every pipeline of the process from now on.
+  Glib::RefPtr<ProcessingTimeTracer> processing_time =
+    Glib::RefPtr<ProcessingTimeTracer>::cast_dynamic(Gst::Tracer::create(
+      Gst::register_mm_tracer<ProcessingTimeTracer>("gstmmprocessingtime")));
+  Glib::RefPtr<QueueLevelTracer> queue_level =
+    Glib::RefPtr<QueueLevelTracer>::cast_dynamic(Gst::Tracer::create(
+      Gst::register_mm_tracer<QueueLevelTracer>("gstmmqueuelevel")));
+  Glib::RefPtr<AllocationTracer> allocation =
+    Glib::RefPtr<AllocationTracer>::cast_dynamic(Gst::Tracer::create(
+      Gst::register_mm_tracer<AllocationTracer>("gstmmallocation")));
+
+  const Glib::ustring description = argc > 1 ? argv[1] :
+    "videotestsrc num-buffers=300 ! queue ! videoconvert ! fakesink";
+
+  Glib::RefPtr<Gst::Element> pipeline;
+  try
+  {
+    pipeline = Gst::Parse::launch(description);
+  }
+  catch(const Glib::Error& error)
+  {
+    std::cerr << "Failed to create the pipeline: " << error.what() << std::endl;
+    return 1;
+  }
+
+  pipeline->set_state(Gst::STATE_PLAYING);
+
+  Glib::RefPtr<Gst::Message> message = pipeline->get_bus()->pop(Gst::CLOCK_TIME_NONE,
+    Gst::MESSAGE_EOS | Gst::MESSAGE_ERROR);
+  if(message && message->get_message_type() == Gst::MESSAGE_ERROR)
+    std::cerr << "The pipeline failed." << std::endl;
+
+  pipeline->set_state(Gst::STATE_NULL);
+
+  processing_time->report(std::cout);
+  queue_level->report(std::cout);
+  allocation->report(std::cout);
+
+  return 0;
+}
@@ -0,0 +1,303 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _GSTREAMERMM_EXAMPLE_TRACERS_H
+#define _GSTREAMERMM_EXAMPLE_TRACERS_H
+
+#include <gstreamermm.h>
+#include <gstreamermm/private/tracer_p.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What the tracers need to know about the elements on both sides of a
+// pushing pad.
+class PadInfo
+{
+public:
+  explicit PadInfo(GstPad* pad)
+  : peer(gst_pad_get_peer(pad)),
+    element_is_queue(false),
+    peer_element_is_queue(false)
+  {
+    GstElement* const parent = gst_pad_get_parent_element(pad);
+    GstElement* const peer_parent = peer ? gst_pad_get_parent_element(peer) : 0;
+
+    // GstQueue only exists once the plugin of the queue was loaded, so it
+    // is looked up for every pad rather than once for the tracer.
+    const GType queue_type = g_type_from_name("GstQueue");
+
+    if(parent)
+    {
+      element = GST_ELEMENT_NAME(parent);
+      element_is_queue = G_OBJECT_TYPE(parent) == queue_type;
+      gst_object_unref(parent);
+    }
+
+    if(peer_parent)
+    {
+      peer_element = GST_ELEMENT_NAME(peer_parent);
+      peer_element_is_queue = G_OBJECT_TYPE(peer_parent) == queue_type;
+      gst_object_unref(peer_parent);
+    }
+  }
+
+  ~PadInfo()
+  {
+    if(peer)
+      gst_object_unref(peer);
+  }
+
+  // The peer the information was collected for.  The reference keeps
+  // another pad from being allocated at the same address.
+  GstPad* const peer;
+
+  std::string element;
+  std::string peer_element;
+  bool element_is_queue;
+  bool peer_element_is_queue;
+
+private:
+  PadInfo(const PadInfo&);
+  PadInfo& operator=(const PadInfo&);
+};
+
+// Gets the PadInfo of pad.  Finding the elements of a pad takes and drops
+// references, which is too slow for every buffer, so the PadInfo is
+// remembered on the pad and only collected again when the pad was linked
+// to another peer.  The returned PadInfo stays valid after that.
+inline std::shared_ptr<const PadInfo> get_pad_info(GstPad* pad)
+{
+  typedef std::shared_ptr<const PadInfo> PadInfoPtr;
+
+  struct Cache
+  {
+    static void destroy(gpointer data)
+    {
+      delete static_cast<PadInfoPtr*>(data);
+    }
+  };
+
+  static const GQuark quark = g_quark_from_static_string("gstreamermm-example-pad-info");
+
+  GST_OBJECT_LOCK(pad);
+  const PadInfoPtr* const cached = static_cast<PadInfoPtr*>(g_object_get_qdata(G_OBJECT(pad), quark));
+  if(cached && (*cached)->peer == GST_PAD_PEER(pad))
+  {
+    const PadInfoPtr info = *cached;
+    GST_OBJECT_UNLOCK(pad);
+    return info;
+  }
+  GST_OBJECT_UNLOCK(pad);
+
+  const PadInfoPtr info(new PadInfo(pad));
+
+  // Replaced under the lock, since the other streaming threads copy it
+  // under the lock.
+  GST_OBJECT_LOCK(pad);
+  PadInfoPtr* const previous = static_cast<PadInfoPtr*>(g_object_steal_qdata(G_OBJECT(pad), quark));
+  g_object_set_qdata_full(G_OBJECT(pad), quark, new PadInfoPtr(info), &Cache::destroy);
+  GST_OBJECT_UNLOCK(pad);
+
+  delete previous;
+  return info;
+}
+
+// Measures the time each element spends processing the buffers pushed to
+// it, excluding the time spent in the elements downstream that it pushes to
+// from the same thread.
+class ProcessingTimeTracer : public Gst::Tracer
+{
+public:
+  explicit ProcessingTimeTracer(GstTracer* gobj)
+  : Gst::Tracer(gobj)
+  {
+    register_hook(Gst::TRACER_HOOK_PAD_PUSH_PRE);
+    register_hook(Gst::TRACER_HOOK_PAD_PUSH_POST);
+  }
+
+  void report(std::ostream& out)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "Processing time per element:" << std::endl;
+    for(std::map<std::string, Stats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+    {
+      out << "  " << it->first << ": " << it->second.buffers << " buffers, "
+        << it->second.time / it->second.buffers << " ns per buffer" << std::endl;
+    }
+  }
+
+protected:
+  virtual void pad_push_pre_vfunc(Gst::ClockTime ts, GstPad* pad, Gst::Buffer&)
+  {
+    Frame frame;
+    frame.pad_info = get_pad_info(pad);
+    frame.start = ts;
+    frame.nested = 0;
+    frames.push_back(frame);
+  }
+
+  virtual void pad_push_post_vfunc(Gst::ClockTime ts, GstPad*, Gst::FlowReturn)
+  {
+    if(frames.empty())
+      return;
+
+    const Frame frame = frames.back();
+    frames.pop_back();
+
+    const Gst::ClockTime total = ts - frame.start;
+    if(!frames.empty())
+      frames.back().nested += total;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats& element_stats = stats[frame.pad_info->peer_element];
+    element_stats.buffers++;
+    element_stats.time += total - frame.nested;
+  }
+
+private:
+  struct Frame
+  {
+    std::shared_ptr<const PadInfo> pad_info;
+    Gst::ClockTime start;
+    Gst::ClockTime nested;
+  };
+
+  struct Stats
+  {
+    Stats() : buffers(0), time(0) {}
+    guint64 buffers;
+    Gst::ClockTime time;
+  };
+
+  // The pushes in progress in the current streaming thread.
+  static thread_local std::vector<Frame> frames;
+
+  std::mutex mutex;
+  std::map<std::string, Stats> stats;
+};
+
+thread_local std::vector<ProcessingTimeTracer::Frame> ProcessingTimeTracer::frames;
+
+// Tracks the number of buffers held by every queue, from the buffers pushed
+// into it and out of it.
+class QueueLevelTracer : public Gst::Tracer
+{
+public:
+  explicit QueueLevelTracer(GstTracer* gobj)
+  : Gst::Tracer(gobj)
+  {
+    register_hook(Gst::TRACER_HOOK_PAD_PUSH_PRE);
+  }
+
+  void report(std::ostream& out)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "Queue levels:" << std::endl;
+    for(std::map<std::string, Level>::const_iterator it = levels.begin(); it != levels.end(); ++it)
+    {
+      out << "  " << it->first << ": " << it->second.current << " buffers, at most "
+        << it->second.max << std::endl;
+    }
+  }
+
+protected:
+  virtual void pad_push_pre_vfunc(Gst::ClockTime, GstPad* pad, Gst::Buffer&)
+  {
+    const std::shared_ptr<const PadInfo> info = get_pad_info(pad);
+
+    if(info->peer_element_is_queue)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      Level& level = levels[info->peer_element];
+      level.current++;
+      if(level.current > level.max)
+        level.max = level.current;
+    }
+
+    if(info->element_is_queue)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      levels[info->element].current--;
+    }
+  }
+
+private:
+  struct Level
+  {
+    Level() : current(0), max(0) {}
+    gint64 current;
+    gint64 max;
+  };
+
+  std::mutex mutex;
+  std::map<std::string, Level> levels;
+};
+
+// Counts the buffers each element pushes, and how many of them come from a
+// buffer pool.  Buffers that do not come from a pool are usually allocated
+// for every frame.
+class AllocationTracer : public Gst::Tracer
+{
+public:
+  explicit AllocationTracer(GstTracer* gobj)
+  : Gst::Tracer(gobj)
+  {
+    register_hook(Gst::TRACER_HOOK_PAD_PUSH_PRE);
+  }
+
+  void report(std::ostream& out)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "Buffer allocations per element:" << std::endl;
+    for(std::map<std::string, Counts>::const_iterator it = counts.begin(); it != counts.end(); ++it)
+    {
+      out << "  " << it->first << ": " << it->second.buffers << " buffers, "
+        << it->second.buffers - it->second.pooled << " not from a pool" << std::endl;
+    }
+  }
+
+protected:
+  virtual void pad_push_pre_vfunc(Gst::ClockTime, GstPad* pad, Gst::Buffer& buffer)
+  {
+    const std::shared_ptr<const PadInfo> info = get_pad_info(pad);
+    const bool pooled = buffer.gobj()->pool != 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Counts& element_counts = counts[info->element];
+    element_counts.buffers++;
+    if(pooled)
+      element_counts.pooled++;
+  }
+
+private:
+  struct Counts
+  {
+    Counts() : buffers(0), pooled(0) {}
+    guint64 buffers;
+    guint64 pooled;
+  };
+
+  std::mutex mutex;
+  std::map<std::string, Counts> counts;
+};
+
+#endif /* _GSTREAMERMM_EXAMPLE_TRACERS_H */
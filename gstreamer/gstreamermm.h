@@ -61,12 +61,16 @@
 #include <gstreamermm/check.h>
 #include <gstreamermm/init.h>
 #include <gstreamermm/version.h>
+#include <gstreamermm/meta.h>
 #include <gstreamermm/register.h>
+#include <gstreamermm/span.h>
 
 // Core includes
+#include <gstreamermm/allocator.h>
 #include <gstreamermm/bin.h>
 #include <gstreamermm/buffer.h>
 #include <gstreamermm/bufferlist.h>
+#include <gstreamermm/bufferpool.h>
 #include <gstreamermm/bus.h>
 #include <gstreamermm/caps.h>
 #include <gstreamermm/childproxy.h>
@@ -97,6 +101,7 @@
 #include <gstreamermm/tagsetter.h>
 #include <gstreamermm/task.h>
 #include <gstreamermm/taskpool.h>
+#include <gstreamermm/tracer.h>
 #include <gstreamermm/typefind.h>
 #include <gstreamermm/typefindfactory.h>
 #include <gstreamermm/urihandler.h>
@@ -112,6 +117,7 @@
 // Base library includes
 #include <gstreamermm/audioclock.h>
 #include <gstreamermm/audiofilter.h>
+#include <gstreamermm/audiokernels.h>
 #include <gstreamermm/audiosink.h>
 #include <gstreamermm/audiosrc.h>
 #include <gstreamermm/audiobasesink.h>
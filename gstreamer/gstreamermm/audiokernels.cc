@@ -0,0 +1,918 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free
+ * Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <gstreamermm/audiokernels.h>
+#include <gst/audio/audio.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#define GSTREAMERMM_KERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GSTREAMERMM_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define GSTREAMERMM_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+using Gst::AudioKernels::InstructionSet;
+
+// The kernels of one instruction set.  Every kernel handles any count,
+// finishing the samples that do not fill a register with the scalar code.
+struct Kernels
+{
+  InstructionSet instruction_set;
+  void (*s16_to_f32)(const gint16* src, float* dest, gsize count);
+  void (*f32_to_s16)(const float* src, gint16* dest, gsize count);
+  void (*s32_to_f32)(const gint32* src, float* dest, gsize count);
+  void (*f32_to_s32)(const float* src, gint32* dest, gsize count);
+  void (*interleave2)(const float* left, const float* right, float* dest, gsize frames);
+  void (*deinterleave2)(const float* src, float* left, float* right, gsize frames);
+  // dest = src * gain, src may be dest.
+  void (*scale)(const float* src, float gain, float* dest, gsize count);
+  // dest += src * gain.
+  void (*mix_add)(const float* src, float gain, float* dest, gsize count);
+};
+
+const float s16_to_f32_factor = 1.0f / 32768.0f;
+const float f32_to_s16_factor = 32768.0f;
+const float s32_to_f32_factor = 1.0f / 2147483648.0f;
+const float f32_to_s32_factor = 2147483648.0f;
+// The largest float below 2^31.
+const float s32_max_float = 2147483520.0f;
+
+// The number of samples converted at once through a temporary buffer.
+const gsize chunk_samples = 256;
+
+void s16_to_f32_scalar(const gint16* src, float* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+    dest[i] = src[i] * s16_to_f32_factor;
+}
+
+void f32_to_s16_scalar(const float* src, gint16* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+  {
+    const float sample = src[i] * f32_to_s16_factor;
+    dest[i] = static_cast<gint16>(lrintf(CLAMP(sample, -32768.0f, 32767.0f)));
+  }
+}
+
+void s32_to_f32_scalar(const gint32* src, float* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+    dest[i] = src[i] * s32_to_f32_factor;
+}
+
+void f32_to_s32_scalar(const float* src, gint32* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+  {
+    const float sample = src[i] * f32_to_s32_factor;
+    dest[i] = static_cast<gint32>(lrintf(CLAMP(sample, -2147483648.0f, s32_max_float)));
+  }
+}
+
+void interleave2_scalar(const float* left, const float* right, float* dest, gsize frames)
+{
+  for(gsize i = 0; i < frames; i++)
+  {
+    dest[2 * i] = left[i];
+    dest[2 * i + 1] = right[i];
+  }
+}
+
+void deinterleave2_scalar(const float* src, float* left, float* right, gsize frames)
+{
+  for(gsize i = 0; i < frames; i++)
+  {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+
+void scale_scalar(const float* src, float gain, float* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+    dest[i] = src[i] * gain;
+}
+
+void mix_add_scalar(const float* src, float gain, float* dest, gsize count)
+{
+  for(gsize i = 0; i < count; i++)
+    dest[i] += src[i] * gain;
+}
+
+const Kernels scalar_kernels =
+{
+  Gst::AudioKernels::INSTRUCTION_SET_SCALAR,
+  &s16_to_f32_scalar,
+  &f32_to_s16_scalar,
+  &s32_to_f32_scalar,
+  &f32_to_s32_scalar,
+  &interleave2_scalar,
+  &deinterleave2_scalar,
+  &scale_scalar,
+  &mix_add_scalar
+};
+
+#ifdef GSTREAMERMM_KERNELS_SSE2
+
+void s16_to_f32_sse2(const gint16* src, float* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(s16_to_f32_factor);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Sign extend by moving each sample to the high half and shifting back.
+    const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(low), factor));
+    _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factor));
+  }
+
+  s16_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+void f32_to_s16_sse2(const float* src, gint16* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(f32_to_s16_factor);
+  const __m128 min = _mm_set1_ps(-32768.0f);
+  const __m128 max = _mm_set1_ps(32767.0f);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m128 low = _mm_mul_ps(_mm_loadu_ps(src + i), factor);
+    const __m128 high = _mm_mul_ps(_mm_loadu_ps(src + i + 4), factor);
+    const __m128i packed = _mm_packs_epi32(
+      _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(low, min), max)),
+      _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(high, min), max)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+  }
+
+  f32_to_s16_scalar(src + i, dest + i, count - i);
+}
+
+void s32_to_f32_sse2(const gint32* src, float* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(s32_to_f32_factor);
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), factor));
+  }
+
+  s32_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+void f32_to_s32_sse2(const float* src, gint32* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(f32_to_s32_factor);
+  const __m128 min = _mm_set1_ps(-2147483648.0f);
+  const __m128 max = _mm_set1_ps(s32_max_float);
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+  {
+    const __m128 samples = _mm_mul_ps(_mm_loadu_ps(src + i), factor);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+      _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(samples, min), max)));
+  }
+
+  f32_to_s32_scalar(src + i, dest + i, count - i);
+}
+
+void interleave2_sse2(const float* left, const float* right, float* dest, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= frames; i += 4)
+  {
+    const __m128 l = _mm_loadu_ps(left + i);
+    const __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(dest + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(dest + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+
+  interleave2_scalar(left + i, right + i, dest + 2 * i, frames - i);
+}
+
+void deinterleave2_sse2(const float* src, float* left, float* right, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= frames; i += 4)
+  {
+    const __m128 first = _mm_loadu_ps(src + 2 * i);
+    const __m128 second = _mm_loadu_ps(src + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+
+  deinterleave2_scalar(src + 2 * i, left + i, right + i, frames - i);
+}
+
+void scale_sse2(const float* src, float gain, float* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(gain);
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(src + i), factor));
+
+  scale_scalar(src + i, gain, dest + i, count - i);
+}
+
+void mix_add_sse2(const float* src, float gain, float* dest, gsize count)
+{
+  const __m128 factor = _mm_set1_ps(gain);
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+  {
+    const __m128 product = _mm_mul_ps(_mm_loadu_ps(src + i), factor);
+    _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), product));
+  }
+
+  mix_add_scalar(src + i, gain, dest + i, count - i);
+}
+
+const Kernels sse2_kernels =
+{
+  Gst::AudioKernels::INSTRUCTION_SET_SSE2,
+  &s16_to_f32_sse2,
+  &f32_to_s16_sse2,
+  &s32_to_f32_sse2,
+  &f32_to_s32_sse2,
+  &interleave2_sse2,
+  &deinterleave2_sse2,
+  &scale_sse2,
+  &mix_add_sse2
+};
+
+#endif // GSTREAMERMM_KERNELS_SSE2
+
+#ifdef GSTREAMERMM_KERNELS_AVX2
+
+// Compiled for AVX2 regardless of the flags of the library, and only called
+// when the CPU supports it.
+#define GSTREAMERMM_AVX2 __attribute__((target("avx2")))
+
+GSTREAMERMM_AVX2 void s16_to_f32_avx2(const gint16* src, float* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(s16_to_f32_factor);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m256i samples = _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(samples), factor));
+  }
+
+  s16_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+GSTREAMERMM_AVX2 void f32_to_s16_avx2(const float* src, gint16* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(f32_to_s16_factor);
+  const __m256 min = _mm256_set1_ps(-32768.0f);
+  const __m256 max = _mm256_set1_ps(32767.0f);
+  gsize i = 0;
+
+  for(; i + 16 <= count; i += 16)
+  {
+    const __m256 low = _mm256_mul_ps(_mm256_loadu_ps(src + i), factor);
+    const __m256 high = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), factor);
+    const __m256i packed = _mm256_packs_epi32(
+      _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(low, min), max)),
+      _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(high, min), max)));
+    // The pack works within each 128-bit lane, restore the sample order.
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+      _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  f32_to_s16_scalar(src + i, dest + i, count - i);
+}
+
+GSTREAMERMM_AVX2 void s32_to_f32_avx2(const gint32* src, float* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(s32_to_f32_factor);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(samples), factor));
+  }
+
+  s32_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+GSTREAMERMM_AVX2 void f32_to_s32_avx2(const float* src, gint32* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(f32_to_s32_factor);
+  const __m256 min = _mm256_set1_ps(-2147483648.0f);
+  const __m256 max = _mm256_set1_ps(s32_max_float);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m256 samples = _mm256_mul_ps(_mm256_loadu_ps(src + i), factor);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+      _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(samples, min), max)));
+  }
+
+  f32_to_s32_scalar(src + i, dest + i, count - i);
+}
+
+GSTREAMERMM_AVX2 void interleave2_avx2(const float* left, const float* right, float* dest, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 8 <= frames; i += 8)
+  {
+    const __m256 l = _mm256_loadu_ps(left + i);
+    const __m256 r = _mm256_loadu_ps(right + i);
+    // Frames 0, 1, 4, 5 and 2, 3, 6, 7.
+    const __m256 low = _mm256_unpacklo_ps(l, r);
+    const __m256 high = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(dest + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(dest + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+  }
+
+  interleave2_scalar(left + i, right + i, dest + 2 * i, frames - i);
+}
+
+GSTREAMERMM_AVX2 void deinterleave2_avx2(const float* src, float* left, float* right, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 8 <= frames; i += 8)
+  {
+    const __m256 first = _mm256_loadu_ps(src + 2 * i);
+    const __m256 second = _mm256_loadu_ps(src + 2 * i + 8);
+    // Frames 0, 1, 4, 5, 2, 3, 6, 7 of each channel.
+    const __m256 l = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 r = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm256_storeu_ps(left + i, _mm256_castpd_ps(
+      _mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+    _mm256_storeu_ps(right + i, _mm256_castpd_ps(
+      _mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+  }
+
+  deinterleave2_scalar(src + 2 * i, left + i, right + i, frames - i);
+}
+
+GSTREAMERMM_AVX2 void scale_avx2(const float* src, float gain, float* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(gain);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), factor));
+
+  scale_scalar(src + i, gain, dest + i, count - i);
+}
+
+GSTREAMERMM_AVX2 void mix_add_avx2(const float* src, float gain, float* dest, gsize count)
+{
+  const __m256 factor = _mm256_set1_ps(gain);
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(src + i), factor);
+    _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), product));
+  }
+
+  mix_add_scalar(src + i, gain, dest + i, count - i);
+}
+
+#undef GSTREAMERMM_AVX2
+
+const Kernels avx2_kernels =
+{
+  Gst::AudioKernels::INSTRUCTION_SET_AVX2,
+  &s16_to_f32_avx2,
+  &f32_to_s16_avx2,
+  &s32_to_f32_avx2,
+  &f32_to_s32_avx2,
+  &interleave2_avx2,
+  &deinterleave2_avx2,
+  &scale_avx2,
+  &mix_add_avx2
+};
+
+#endif // GSTREAMERMM_KERNELS_AVX2
+
+#ifdef GSTREAMERMM_KERNELS_NEON
+
+void s16_to_f32_neon(const gint16* src, float* dest, gsize count)
+{
+  gsize i = 0;
+
+  for(; i + 8 <= count; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(src + i);
+    vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), s16_to_f32_factor));
+    vst1q_f32(dest + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_high_s16(samples)), s16_to_f32_factor));
+  }
+
+  s16_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+void f32_to_s16_neon(const float* src, gint16* dest, gsize count)
+{
+  gsize i = 0;
+
+  // The saturating narrowing clips, vcvtnq rounds to nearest like lrintf().
+  for(; i + 8 <= count; i += 8)
+  {
+    const int32x4_t low = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), f32_to_s16_factor));
+    const int32x4_t high = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), f32_to_s16_factor));
+    vst1q_s16(dest + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+  }
+
+  f32_to_s16_scalar(src + i, dest + i, count - i);
+}
+
+void s32_to_f32_neon(const gint32* src, float* dest, gsize count)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+    vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), s32_to_f32_factor));
+
+  s32_to_f32_scalar(src + i, dest + i, count - i);
+}
+
+void f32_to_s32_neon(const float* src, gint32* dest, gsize count)
+{
+  const float32x4_t min = vdupq_n_f32(-2147483648.0f);
+  const float32x4_t max = vdupq_n_f32(s32_max_float);
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+  {
+    const float32x4_t samples = vmulq_n_f32(vld1q_f32(src + i), f32_to_s32_factor);
+    vst1q_s32(dest + i, vcvtnq_s32_f32(vminq_f32(vmaxq_f32(samples, min), max)));
+  }
+
+  f32_to_s32_scalar(src + i, dest + i, count - i);
+}
+
+void interleave2_neon(const float* left, const float* right, float* dest, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t frame;
+    frame.val[0] = vld1q_f32(left + i);
+    frame.val[1] = vld1q_f32(right + i);
+    vst2q_f32(dest + 2 * i, frame);
+  }
+
+  interleave2_scalar(left + i, right + i, dest + 2 * i, frames - i);
+}
+
+void deinterleave2_neon(const float* src, float* left, float* right, gsize frames)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= frames; i += 4)
+  {
+    const float32x4x2_t frame = vld2q_f32(src + 2 * i);
+    vst1q_f32(left + i, frame.val[0]);
+    vst1q_f32(right + i, frame.val[1]);
+  }
+
+  deinterleave2_scalar(src + 2 * i, left + i, right + i, frames - i);
+}
+
+void scale_neon(const float* src, float gain, float* dest, gsize count)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+    vst1q_f32(dest + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+
+  scale_scalar(src + i, gain, dest + i, count - i);
+}
+
+void mix_add_neon(const float* src, float gain, float* dest, gsize count)
+{
+  gsize i = 0;
+
+  for(; i + 4 <= count; i += 4)
+    vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), vmulq_n_f32(vld1q_f32(src + i), gain)));
+
+  mix_add_scalar(src + i, gain, dest + i, count - i);
+}
+
+const Kernels neon_kernels =
+{
+  Gst::AudioKernels::INSTRUCTION_SET_NEON,
+  &s16_to_f32_neon,
+  &f32_to_s16_neon,
+  &s32_to_f32_neon,
+  &f32_to_s32_neon,
+  &interleave2_neon,
+  &deinterleave2_neon,
+  &scale_neon,
+  &mix_add_neon
+};
+
+#endif // GSTREAMERMM_KERNELS_NEON
+
+// Gets the kernels of @a instruction_set, or 0 if the CPU does not support
+// it.
+const Kernels* find_kernels(InstructionSet instruction_set)
+{
+  switch(instruction_set)
+  {
+    case Gst::AudioKernels::INSTRUCTION_SET_SCALAR:
+      return &scalar_kernels;
+#ifdef GSTREAMERMM_KERNELS_SSE2
+    case Gst::AudioKernels::INSTRUCTION_SET_SSE2:
+      return &sse2_kernels;
+#endif
+#ifdef GSTREAMERMM_KERNELS_AVX2
+    case Gst::AudioKernels::INSTRUCTION_SET_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? &avx2_kernels : 0;
+#endif
+#ifdef GSTREAMERMM_KERNELS_NEON
+    case Gst::AudioKernels::INSTRUCTION_SET_NEON:
+      return &neon_kernels;
+#endif
+    default:
+      return 0;
+  }
+}
+
+const Kernels* find_best_kernels()
+{
+  const InstructionSet preferred[] =
+  {
+    Gst::AudioKernels::INSTRUCTION_SET_AVX2,
+    Gst::AudioKernels::INSTRUCTION_SET_NEON,
+    Gst::AudioKernels::INSTRUCTION_SET_SSE2
+  };
+
+  for(gsize i = 0; i < G_N_ELEMENTS(preferred); i++)
+  {
+    if(const Kernels* kernels = find_kernels(preferred[i]))
+      return kernels;
+  }
+
+  return &scalar_kernels;
+}
+
+std::atomic<const Kernels*>& current_kernels()
+{
+  static std::atomic<const Kernels*> current(find_best_kernels());
+  return current;
+}
+
+const Kernels& kernels()
+{
+  return *current_kernels().load(std::memory_order_relaxed);
+}
+
+// Gets the information of a format that has an unpack and a pack function,
+// or 0.
+const GstAudioFormatInfo* get_format_info(Gst::AudioFormat format)
+{
+  const GstAudioFormat c_format = static_cast<GstAudioFormat>(format);
+  if(c_format == GST_AUDIO_FORMAT_UNKNOWN || c_format == GST_AUDIO_FORMAT_ENCODED)
+    return 0;
+
+  const GstAudioFormatInfo* const info = gst_audio_format_get_info(c_format);
+  if(!info || info->width <= 0 || info->width % 8 || !info->unpack_func || !info->pack_func)
+    return 0;
+
+  return info;
+}
+
+gint32 f64_to_s32(gdouble sample)
+{
+  sample *= 2147483648.0;
+  return static_cast<gint32>(lrint(CLAMP(sample, -2147483648.0, 2147483647.0)));
+}
+
+} // anonymous namespace
+
+namespace Gst
+{
+
+namespace AudioKernels
+{
+
+InstructionSet get_instruction_set()
+{
+  return kernels().instruction_set;
+}
+
+InstructionSet set_instruction_set(InstructionSet instruction_set)
+{
+  if(const Kernels* const found = find_kernels(instruction_set))
+    current_kernels().store(found);
+
+  return get_instruction_set();
+}
+
+gsize unpack_f32(AudioFormat format, Span<const guint8> src, Span<float> dest)
+{
+  const GstAudioFormatInfo* const info = get_format_info(format);
+  if(!info)
+    return 0;
+
+  const gsize sample_size = info->width / 8;
+  const gsize count = MIN(src.size() / sample_size, dest.size());
+
+  switch(info->format)
+  {
+    case GST_AUDIO_FORMAT_S16:
+      kernels().s16_to_f32(reinterpret_cast<const gint16*>(src.data()), dest.data(), count);
+      return count;
+    case GST_AUDIO_FORMAT_S32:
+      kernels().s32_to_f32(reinterpret_cast<const gint32*>(src.data()), dest.data(), count);
+      return count;
+    case GST_AUDIO_FORMAT_F32:
+      std::memcpy(dest.data(), src.data(), count * sizeof(float));
+      return count;
+    default:
+      break;
+  }
+
+  // Other formats are unpacked by gstreamer to S32 or F64.
+  for(gsize done = 0; done < count; done += chunk_samples)
+  {
+    const gsize chunk = MIN(count - done, chunk_samples);
+    guint8* const data = const_cast<guint8*>(src.data()) + done * sample_size;
+
+    if(info->unpack_format == GST_AUDIO_FORMAT_F64)
+    {
+      gdouble samples[chunk_samples];
+      info->unpack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, data, chunk);
+      for(gsize i = 0; i < chunk; i++)
+        dest[done + i] = static_cast<float>(samples[i]);
+    }
+    else
+    {
+      gint32 samples[chunk_samples];
+      info->unpack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, data, chunk);
+      kernels().s32_to_f32(samples, dest.data() + done, chunk);
+    }
+  }
+
+  return count;
+}
+
+gsize pack_f32(AudioFormat format, Span<const float> src, Span<guint8> dest)
+{
+  const GstAudioFormatInfo* const info = get_format_info(format);
+  if(!info)
+    return 0;
+
+  const gsize sample_size = info->width / 8;
+  const gsize count = MIN(src.size(), dest.size() / sample_size);
+
+  switch(info->format)
+  {
+    case GST_AUDIO_FORMAT_S16:
+      kernels().f32_to_s16(src.data(), reinterpret_cast<gint16*>(dest.data()), count);
+      return count;
+    case GST_AUDIO_FORMAT_S32:
+      kernels().f32_to_s32(src.data(), reinterpret_cast<gint32*>(dest.data()), count);
+      return count;
+    case GST_AUDIO_FORMAT_F32:
+      std::memcpy(dest.data(), src.data(), count * sizeof(float));
+      return count;
+    default:
+      break;
+  }
+
+  for(gsize done = 0; done < count; done += chunk_samples)
+  {
+    const gsize chunk = MIN(count - done, chunk_samples);
+    guint8* const data = dest.data() + done * sample_size;
+
+    if(info->unpack_format == GST_AUDIO_FORMAT_F64)
+    {
+      gdouble samples[chunk_samples];
+      for(gsize i = 0; i < chunk; i++)
+        samples[i] = src[done + i];
+      info->pack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, data, chunk);
+    }
+    else
+    {
+      gint32 samples[chunk_samples];
+      kernels().f32_to_s32(src.data() + done, samples, chunk);
+      info->pack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, data, chunk);
+    }
+  }
+
+  return count;
+}
+
+gsize unpack_s32(AudioFormat format, Span<const guint8> src, Span<gint32> dest)
+{
+  const GstAudioFormatInfo* const info = get_format_info(format);
+  if(!info)
+    return 0;
+
+  const gsize sample_size = info->width / 8;
+  const gsize count = MIN(src.size() / sample_size, dest.size());
+
+  switch(info->format)
+  {
+    case GST_AUDIO_FORMAT_F32:
+      kernels().f32_to_s32(reinterpret_cast<const float*>(src.data()), dest.data(), count);
+      return count;
+    case GST_AUDIO_FORMAT_S32:
+      std::memcpy(dest.data(), src.data(), count * sizeof(gint32));
+      return count;
+    default:
+      break;
+  }
+
+  guint8* const data = const_cast<guint8*>(src.data());
+
+  if(info->unpack_format != GST_AUDIO_FORMAT_F64)
+  {
+    info->unpack_func(info, GST_AUDIO_PACK_FLAG_NONE, dest.data(), data, count);
+    return count;
+  }
+
+  for(gsize done = 0; done < count; done += chunk_samples)
+  {
+    const gsize chunk = MIN(count - done, chunk_samples);
+    gdouble samples[chunk_samples];
+    info->unpack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, data + done * sample_size, chunk);
+    for(gsize i = 0; i < chunk; i++)
+      dest[done + i] = f64_to_s32(samples[i]);
+  }
+
+  return count;
+}
+
+gsize pack_s32(AudioFormat format, Span<const gint32> src, Span<guint8> dest)
+{
+  const GstAudioFormatInfo* const info = get_format_info(format);
+  if(!info)
+    return 0;
+
+  const gsize sample_size = info->width / 8;
+  const gsize count = MIN(src.size(), dest.size() / sample_size);
+
+  switch(info->format)
+  {
+    case GST_AUDIO_FORMAT_F32:
+      kernels().s32_to_f32(src.data(), reinterpret_cast<float*>(dest.data()), count);
+      return count;
+    case GST_AUDIO_FORMAT_S32:
+      std::memcpy(dest.data(), src.data(), count * sizeof(gint32));
+      return count;
+    default:
+      break;
+  }
+
+  gint32* const samples = const_cast<gint32*>(src.data());
+
+  if(info->unpack_format != GST_AUDIO_FORMAT_F64)
+  {
+    info->pack_func(info, GST_AUDIO_PACK_FLAG_NONE, samples, dest.data(), count);
+    return count;
+  }
+
+  for(gsize done = 0; done < count; done += chunk_samples)
+  {
+    const gsize chunk = MIN(count - done, chunk_samples);
+    gdouble converted[chunk_samples];
+    for(gsize i = 0; i < chunk; i++)
+      converted[i] = samples[done + i] / 2147483648.0;
+    info->pack_func(info, GST_AUDIO_PACK_FLAG_NONE, converted, dest.data() + done * sample_size, chunk);
+  }
+
+  return count;
+}
+
+void interleave(const float* const* planes, guint channels, Span<float> dest)
+{
+  if(!channels)
+    return;
+
+  const gsize frames = dest.size() / channels;
+
+  if(channels == 1)
+    std::memcpy(dest.data(), planes[0], frames * sizeof(float));
+  else if(channels == 2)
+    kernels().interleave2(planes[0], planes[1], dest.data(), frames);
+  else
+  {
+    for(gsize i = 0; i < frames; i++)
+      for(guint c = 0; c < channels; c++)
+        dest[i * channels + c] = planes[c][i];
+  }
+}
+
+void deinterleave(Span<const float> src, guint channels, float* const* planes)
+{
+  if(!channels)
+    return;
+
+  const gsize frames = src.size() / channels;
+
+  if(channels == 1)
+    std::memcpy(planes[0], src.data(), frames * sizeof(float));
+  else if(channels == 2)
+    kernels().deinterleave2(src.data(), planes[0], planes[1], frames);
+  else
+  {
+    for(gsize i = 0; i < frames; i++)
+      for(guint c = 0; c < channels; c++)
+        planes[c][i] = src[i * channels + c];
+  }
+}
+
+void apply_gain(Span<float> samples, float gain)
+{
+  kernels().scale(samples.data(), gain, samples.data(), samples.size());
+}
+
+void mix(const float* const* planes, const float* gains, guint channels, Span<float> dest)
+{
+  if(!channels)
+  {
+    std::fill(dest.begin(), dest.end(), 0.0f);
+    return;
+  }
+
+  if(dest.empty())
+    return;
+
+  // The first plane is scaled into dest before the others are added, so a
+  // plane that is dest itself has to be that first one.
+  guint first = channels;
+  for(guint c = 0; c < channels; c++)
+  {
+    if(planes[c] == dest.data())
+    {
+      g_return_if_fail(first == channels);
+      first = c;
+    }
+    else
+      g_return_if_fail(planes[c] + dest.size() <= dest.data() || planes[c] >= dest.data() + dest.size());
+  }
+
+  if(first == channels)
+    first = 0;
+
+  const Kernels& current = kernels();
+  current.scale(planes[first], gains[first], dest.data(), dest.size());
+  for(guint c = 0; c < channels; c++)
+  {
+    if(c != first)
+      current.mix_add(planes[c], gains[c], dest.data(), dest.size());
+  }
+}
+
+} // namespace AudioKernels
+
+} // namespace Gst
@@ -0,0 +1,147 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free
+ * Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _GSTREAMERMM_AUDIOKERNELS_H
+#define _GSTREAMERMM_AUDIOKERNELS_H
+
+#include <gstreamermm/audioformat.h>
+#include <gstreamermm/span.h>
+
+namespace Gst
+{
+
+/** Sample processing kernels for C++ audio elements.
+ * The kernels convert samples of any Gst::AudioFormat from and to 32-bit
+ * float or integer samples, interleave and deinterleave channels, apply a
+ * gain and mix channels.  A Gst::AudioFilter can unpack its input to float,
+ * process it and pack it again without writing per-sample loops:
+ * @code
+ * const gsize samples = map_info.get_size() / sample_size;
+ * Gst::AudioKernels::unpack_f32(format,
+ *   Gst::Span<const guint8>(map_info.get_data(), map_info.get_size()),
+ *   Gst::Span<float>(work, samples));
+ * Gst::AudioKernels::apply_gain(Gst::Span<float>(work, samples), 0.5f);
+ * @endcode
+ *
+ * The conversions of native endian S16, S32 and F32 samples, and the other
+ * kernels, use SSE2 or AVX2 on x86 and NEON on 64-bit ARM, chosen at run
+ * time from what the CPU supports.  Other formats are unpacked and packed by
+ * the functions of gstreamer and then converted.  Integer samples map to
+ * float in the range [-1, 1); packing clips samples outside of this range.
+ */
+namespace AudioKernels
+{
+
+/** The instruction sets that the kernels can use.
+ */
+enum InstructionSet
+{
+  INSTRUCTION_SET_SCALAR,
+  INSTRUCTION_SET_SSE2,
+  INSTRUCTION_SET_AVX2,
+  INSTRUCTION_SET_NEON
+};
+
+/** Gets the instruction set used by the kernels.
+ */
+InstructionSet get_instruction_set();
+
+/** Limits the kernels to @a instruction_set, for example to compare them
+ * with the scalar implementation.  Instruction sets that the CPU does not
+ * support are ignored.  This is not meant to be called while kernels run on
+ * other threads.
+ * @param instruction_set The instruction set to use.
+ * @return The instruction set that is used from now on.
+ */
+InstructionSet set_instruction_set(InstructionSet instruction_set);
+
+/** Converts samples of @a format to float.
+ * @param format The format of @a src.
+ * @param src The samples to convert.
+ * @param dest The storage for the converted samples.
+ * @return The number of samples converted, the number of whole samples in
+ * @a src or the size of @a dest, whichever is smaller; 0 if @a format is not
+ * a known format.
+ */
+gsize unpack_f32(AudioFormat format, Span<const guint8> src, Span<float> dest);
+
+/** Converts float samples to @a format.
+ * @param format The format of @a dest.
+ * @param src The samples to convert.
+ * @param dest The storage for the converted samples.
+ * @return The number of samples converted, 0 if @a format is not a known
+ * format.
+ */
+gsize pack_f32(AudioFormat format, Span<const float> src, Span<guint8> dest);
+
+/** Converts samples of @a format to 32-bit integers.
+ * @param format The format of @a src.
+ * @param src The samples to convert.
+ * @param dest The storage for the converted samples.
+ * @return The number of samples converted, 0 if @a format is not a known
+ * format.
+ */
+gsize unpack_s32(AudioFormat format, Span<const guint8> src, Span<gint32> dest);
+
+/** Converts 32-bit integer samples to @a format.
+ * @param format The format of @a dest.
+ * @param src The samples to convert.
+ * @param dest The storage for the converted samples.
+ * @return The number of samples converted, 0 if @a format is not a known
+ * format.
+ */
+gsize pack_s32(AudioFormat format, Span<const gint32> src, Span<guint8> dest);
+
+/** Interleaves @a channels planes into @a dest.
+ * @param planes The samples of each channel, each at least
+ * <tt>dest.size() / channels</tt> samples.
+ * @param channels The number of channels.
+ * @param dest The storage for the interleaved samples.
+ */
+void interleave(const float* const* planes, guint channels, Span<float> dest);
+
+/** Splits the interleaved samples of @a src into @a channels planes.
+ * @param src The interleaved samples.
+ * @param channels The number of channels.
+ * @param planes The storage for the samples of each channel, each at least
+ * <tt>src.size() / channels</tt> samples.
+ */
+void deinterleave(Span<const float> src, guint channels, float* const* planes);
+
+/** Multiplies @a samples by @a gain in place.
+ */
+void apply_gain(Span<float> samples, float gain);
+
+/** Mixes @a channels planes into @a dest, each plane multiplied by its gain.
+ * This mixes several streams, or downmixes the channels of a deinterleaved
+ * stream.
+ * @param planes The samples to mix, each at least <tt>dest.size()</tt>
+ * samples.
+ * @param gains The gain of each plane.
+ * @param channels The number of planes.
+ * @param dest The storage for the mix. It may be one of @a planes, to mix in
+ * place, but must not otherwise overlap any of them.
+ */
+void mix(const float* const* planes, const float* gains, guint channels, Span<float> dest);
+
+} // namespace AudioKernels
+
+} // namespace Gst
+
+#endif //_GSTREAMERMM_AUDIOKERNELS_H
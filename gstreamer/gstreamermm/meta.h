@@ -0,0 +1,421 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free
+ * Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _GSTREAMERMM_META_H
+#define _GSTREAMERMM_META_H
+
+#include <gst/gst.h>
+#include <glibmm/exceptionhandler.h>
+#include <gstreamermm/handle_error.h>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace Gst
+{
+
+/** Per-buffer metadata holding a C++ value.
+ * Meta<T> registers @a T as a GstMeta API and implementation, so that a
+ * value of type @a T can be attached to a Gst::Buffer and travels with it
+ * through the pipeline:
+ * @code
+ * struct RegionOfInterest
+ * {
+ *   int x, y, width, height;
+ * };
+ *
+ * buffer->add_meta<RegionOfInterest>(RegionOfInterest{ 16, 16, 64, 64 });
+ * ...
+ * if(const RegionOfInterest* roi = buffer->get_meta<RegionOfInterest>())
+ *   crop(*roi);
+ * @endcode
+ *
+ * The value is constructed in place in the GstMeta allocated by gstreamer,
+ * so attaching metadata does not allocate beyond what gstreamer allocates
+ * for any meta.  It is destroyed with the meta.  When a buffer is copied,
+ * the value is copied into the new buffer if @a T is copy constructible.
+ *
+ * The type is registered on first use, under a name derived from
+ * typeid(T).  That name depends on the compiler, and two modules that each
+ * use Meta<T> for the same @a T try to register it twice, which throws an
+ * exception.  Call register_meta() before the first use to choose a stable,
+ * unique name and the tags of the API instead, for example to let other
+ * elements look the API up by name.  The alignment of @a T may not exceed
+ * the alignment gstreamer guarantees for a GstMeta, the one of a pointer.
+ */
+template <class T>
+class Meta
+{
+public:
+  typedef T value_type;
+
+  /** Registers the meta API of @a T.
+   * @param name The name of the meta implementation.  The API is registered
+   * as @a name followed by "API".
+   * @param tags The tags of the API, such as "video" or "size", which tell
+   * which transformations make the metadata invalid.
+   * @return true if the meta was registered, false if Meta<T> was already
+   * registered.  An exception is thrown if @a name is already taken, for
+   * example by another module.
+   */
+  static bool register_meta(const std::string& name, const std::vector<std::string>& tags = std::vector<std::string>());
+
+  /** Gets the registered GstMetaInfo of @a T, registering it if needed.
+   */
+  static const GstMetaInfo* get_info();
+
+  /** Gets the GType of the meta API of @a T, registering it if needed.
+   */
+  static GType get_api_type();
+
+  /** Gets the value held by @a meta.
+   * @param meta A GstMeta.
+   * @return The value, or <tt>0</tt> if @a meta does not hold a @a T.
+   */
+  static T* get(GstMeta* meta);
+
+  /** Gets the value of the first Meta<T> of @a buffer.
+   * @return The value, or <tt>0</tt> if @a buffer has no Meta<T>.
+   */
+  static T* find(GstBuffer* buffer);
+
+  /** Attaches a new Meta<T> to the writable @a buffer.  The value is
+   * constructed from @a args.  Exceptions thrown by the constructor of @a T
+   * are propagated.
+   * @return The new value, or <tt>0</tt> if the meta could not be added.
+   */
+  template <class... Args>
+  static T* add(GstBuffer* buffer, Args&&... args);
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  struct Storage
+  {
+    GstMeta meta;
+    T value;
+  };
+
+  // The parameters handed to gst_buffer_add_meta(), constructing the value.
+  struct Constructor
+  {
+    void (*construct)(void* storage, void* closure);
+    void* closure;
+    std::exception_ptr error;
+  };
+
+  // gstreamer allocates the GstMeta inside a larger structure, which only
+  // guarantees the alignment of the GstMeta itself.
+  static_assert(std::alignment_of<T>::value <= std::alignment_of<GstMeta>::value,
+    "Gst::Meta<T> does not support types aligned more than a pointer.");
+
+  static std::atomic<const GstMetaInfo*> info_;
+  static std::mutex mutex_;
+
+  static const GstMetaInfo* register_locked(const std::string& name, const std::vector<std::string>& tags);
+  static std::string default_name();
+
+  template <class F>
+  static void invoke(void* storage, void* closure)
+  {
+    (*static_cast<F*>(closure))(storage);
+  }
+
+  static gboolean default_construct(Storage* storage, std::true_type)
+  {
+    new(&storage->value) T();
+    return TRUE;
+  }
+
+  static gboolean default_construct(Storage*, std::false_type)
+  {
+    return FALSE;
+  }
+
+  static gboolean copy_to(GstBuffer* dest, const T& value, std::true_type)
+  {
+    return add(dest, value) != 0;
+  }
+
+  static gboolean copy_to(GstBuffer*, const T&, std::false_type)
+  {
+    return FALSE;
+  }
+
+  static gboolean init_callback(GstMeta* meta, gpointer params, GstBuffer* buffer);
+  static void free_callback(GstMeta* meta, GstBuffer* buffer);
+  static gboolean transform_callback(GstBuffer* dest, GstMeta* meta, GstBuffer* buffer, GQuark type, gpointer data);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+};
+
+/** An input iterator over the GstMeta of a buffer, see
+ * Gst::Buffer::get_metas().  Use Gst::Meta<T>::get() to access the value of
+ * a meta defined in C++.  The buffer may not be modified during the
+ * iteration.
+ */
+class MetaIterator
+{
+public:
+  typedef std::input_iterator_tag iterator_category;
+  typedef GstMeta* value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef GstMeta* const* pointer;
+  typedef GstMeta* const& reference;
+
+  MetaIterator()
+  : buffer_(0),
+    state_(0),
+    meta_(0)
+  {}
+
+  explicit MetaIterator(GstBuffer* buffer)
+  : buffer_(buffer),
+    state_(0),
+    meta_(gst_buffer_iterate_meta(buffer, &state_))
+  {}
+
+  reference operator*() const { return meta_; }
+
+  MetaIterator& operator++()
+  {
+    meta_ = gst_buffer_iterate_meta(buffer_, &state_);
+    return *this;
+  }
+
+  MetaIterator operator++(int)
+  {
+    MetaIterator previous(*this);
+    ++*this;
+    return previous;
+  }
+
+  bool operator==(const MetaIterator& other) const { return meta_ == other.meta_; }
+  bool operator!=(const MetaIterator& other) const { return meta_ != other.meta_; }
+
+private:
+  GstBuffer* buffer_;
+  gpointer state_;
+  GstMeta* meta_;
+};
+
+/** The range of the GstMeta of a buffer, usable in a range-based for loop.
+ */
+class MetaRange
+{
+public:
+  explicit MetaRange(GstBuffer* buffer)
+  : buffer_(buffer)
+  {}
+
+  MetaIterator begin() const { return MetaIterator(buffer_); }
+  MetaIterator end() const { return MetaIterator(); }
+
+private:
+  GstBuffer* buffer_;
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <class T>
+std::atomic<const GstMetaInfo*> Meta<T>::info_(0);
+
+template <class T>
+std::mutex Meta<T>::mutex_;
+
+template <class T>
+std::string Meta<T>::default_name()
+{
+  // GType names may only contain alphanumeric characters and -_+.
+  std::string name = std::string("Gstmm") + typeid(T).name();
+  for(std::string::iterator it = name.begin(); it != name.end(); ++it)
+  {
+    if(!g_ascii_isalnum(*it) && *it != '-' && *it != '_' && *it != '+')
+      *it = '_';
+  }
+  return name;
+}
+
+template <class T>
+const GstMetaInfo* Meta<T>::register_locked(const std::string& name, const std::vector<std::string>& tags)
+{
+  std::vector<const gchar*> c_tags;
+  for(std::vector<std::string>::const_iterator it = tags.begin(); it != tags.end(); ++it)
+    c_tags.push_back(it->c_str());
+  c_tags.push_back(0);
+
+  // gstreamer only warns about names that are taken, and the metas of
+  // another type would then be taken for T.
+  if(g_type_from_name((name + "API").c_str()) || g_type_from_name(name.c_str()))
+  {
+    gstreamermm_handle_error("Gst::Meta<T>: the meta name " + name +
+      " is already registered; call Gst::Meta<T>::register_meta() with a unique name.");
+    return 0;
+  }
+
+  const GType api = gst_meta_api_type_register((name + "API").c_str(), &c_tags[0]);
+  const GstMetaInfo* const info = api ? gst_meta_register(api, name.c_str(), sizeof(Storage),
+    &init_callback, &free_callback, &transform_callback) : 0;
+
+  if(!info)
+    gstreamermm_handle_error("Gst::Meta<T>: failed to register the meta " + name + ".");
+
+  return info;
+}
+
+template <class T>
+bool Meta<T>::register_meta(const std::string& name, const std::vector<std::string>& tags)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(info_.load(std::memory_order_relaxed))
+    return false;
+
+  const GstMetaInfo* const info = register_locked(name, tags);
+  info_.store(info, std::memory_order_release);
+  return info != 0;
+}
+
+template <class T>
+const GstMetaInfo* Meta<T>::get_info()
+{
+  const GstMetaInfo* info = info_.load(std::memory_order_acquire);
+  if(info)
+    return info;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  info = info_.load(std::memory_order_relaxed);
+  if(!info)
+  {
+    info = register_locked(default_name(), std::vector<std::string>());
+    info_.store(info, std::memory_order_release);
+  }
+  return info;
+}
+
+template <class T>
+GType Meta<T>::get_api_type()
+{
+  const GstMetaInfo* const info = get_info();
+  return info ? info->api : G_TYPE_INVALID;
+}
+
+template <class T>
+T* Meta<T>::get(GstMeta* meta)
+{
+  if(!meta || meta->info != get_info())
+    return 0;
+
+  return &reinterpret_cast<Storage*>(meta)->value;
+}
+
+template <class T>
+T* Meta<T>::find(GstBuffer* buffer)
+{
+  return get(gst_buffer_get_meta(buffer, get_api_type()));
+}
+
+template <class T>
+template <class... Args>
+T* Meta<T>::add(GstBuffer* buffer, Args&&... args)
+{
+  auto construct = [&args...](void* storage)
+  {
+    new(storage) T(std::forward<Args>(args)...);
+  };
+
+  Constructor constructor;
+  constructor.construct = &invoke<decltype(construct)>;
+  constructor.closure = &construct;
+
+  GstMeta* const meta = gst_buffer_add_meta(buffer, get_info(), &constructor);
+
+  if(constructor.error)
+    std::rethrow_exception(constructor.error);
+
+  return meta ? &reinterpret_cast<Storage*>(meta)->value : 0;
+}
+
+template <class T>
+gboolean Meta<T>::init_callback(GstMeta* meta, gpointer params, GstBuffer*)
+{
+  Storage* const storage = reinterpret_cast<Storage*>(meta);
+
+  // Metas added from C carry no constructor, their value is default
+  // constructed.
+  if(!params)
+  {
+    try
+    {
+      return default_construct(storage, std::is_default_constructible<T>());
+    }
+    catch(...)
+    {
+      Glib::exception_handlers_invoke();
+    }
+
+    return FALSE;
+  }
+
+  Constructor* const constructor = static_cast<Constructor*>(params);
+  try
+  {
+    constructor->construct(&storage->value, constructor->closure);
+    return TRUE;
+  }
+  catch(...)
+  {
+    // Rethrown by add() once gstreamer has freed the meta.
+    constructor->error = std::current_exception();
+    return FALSE;
+  }
+}
+
+template <class T>
+void Meta<T>::free_callback(GstMeta* meta, GstBuffer*)
+{
+  reinterpret_cast<Storage*>(meta)->value.~T();
+}
+
+template <class T>
+gboolean Meta<T>::transform_callback(GstBuffer* dest, GstMeta* meta, GstBuffer*, GQuark type, gpointer)
+{
+  if(!GST_META_TRANSFORM_IS_COPY(type))
+    return FALSE;
+
+  try
+  {
+    return copy_to(dest, reinterpret_cast<Storage*>(meta)->value,
+      std::is_copy_constructible<T>());
+  }
+  catch(...)
+  {
+    Glib::exception_handlers_invoke();
+  }
+
+  return FALSE;
+}
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+} // namespace Gst
+
+#endif //_GSTREAMERMM_META_H
@@ -23,10 +23,124 @@
 #include <glib-object.h>
 #include <glibmm/property.h>
 #include <gstreamermm/padtemplate.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 namespace Gst
 {
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// The C++ object of a type registered with register_mm_type() or
+// register_mm_tracer(), constructed in place inside its C instance.  glibmm
+// deletes the wrapper when the C instance is finalized; the destructor runs
+// then, and the memory is freed later with the C instance.
+// As the most derived class, MMObject constructs the virtual Glib::ObjectBase
+// base instead of DerivedCppType, with the name of the registered GType.
+template<class DerivedCppType>
+class MMObject : public DerivedCppType
+{
+public:
+  MMObject(typename DerivedCppType::BaseObjectType* gobj, const char* custom_type_name)
+    : Glib::ObjectBase(custom_type_name), DerivedCppType(gobj)
+  {}
+
+  static void* operator new(std::size_t, void* place) { return place; }
+  static void operator delete(void*, void*) {}
+  static void operator delete(void*) {}
+};
+
+// The start of the C instance of a type registered with register_mm_type()
+// or register_mm_tracer(), which does not depend on DerivedCppType: the C
+// instance of the wrapped class, followed by the C++ object as the wrapped
+// class CppObjectType.  Callbacks shared by all the registered subclasses of
+// CppObjectType, like the hooks of Gst::Tracer, get the C++ object from
+// there instead of looking up the wrapper and dynamic_casting it.
+template<class CppObjectType>
+struct MMInstanceHead
+{
+  typename CppObjectType::BaseObjectType parent;
+  CppObjectType* object;
+
+  static CppObjectType* get(typename CppObjectType::BaseObjectType* gobj)
+  {
+    return reinterpret_cast<MMInstanceHead*>(gobj)->object;
+  }
+};
+
+// The C instance of a type registered with register_mm_type() or
+// register_mm_tracer().  The C++ object is kept in place when the instance
+// stays within the 64 KiB that GTypeInfo allows and the allocator of
+// GObject instances aligns it well enough; otherwise it is allocated.
+template<class DerivedCppType, bool in_place =
+  sizeof(MMInstanceHead<typename DerivedCppType::CppObjectType>) + sizeof(MMObject<DerivedCppType>) +
+  std::alignment_of<MMObject<DerivedCppType> >::value <= G_MAXUINT16 &&
+  std::alignment_of<MMObject<DerivedCppType> >::value <= 2 * sizeof(gpointer)>
+struct MMInstance
+{
+  MMInstanceHead<typename DerivedCppType::CppObjectType> head;
+  typename std::aligned_storage<sizeof(MMObject<DerivedCppType>),
+    std::alignment_of<MMObject<DerivedCppType> >::value>::type storage;
+
+  // The name of the GType registered for DerivedCppType, set before the
+  // first instance is created.
+  static const char* type_name;
+
+  static void init(MMInstance* instance, gpointer)
+  {
+    //instance->head.parent will be passed to C++ base of DerivedCppType; this will cause registering the object in "storage" as MM wrapper of "parent"
+    instance->head.object = new(&instance->storage) MMObject<DerivedCppType>(&instance->head.parent, type_name);
+  }
+
+  static DerivedCppType* get(typename DerivedCppType::BaseObjectType* gobj)
+  {
+    return reinterpret_cast<MMObject<DerivedCppType>*>(&reinterpret_cast<MMInstance*>(gobj)->storage);
+  }
+};
+
+template<class DerivedCppType, bool in_place>
+const char* MMInstance<DerivedCppType, in_place>::type_name = 0;
+
+template<class DerivedCppType>
+struct MMInstance<DerivedCppType, false>
+{
+  MMInstanceHead<typename DerivedCppType::CppObjectType> head;
+  DerivedCppType *self;
+
+  // Unused: DerivedCppType constructs Glib::ObjectBase itself.
+  static const char* type_name;
+
+  static void init(MMInstance* instance, gpointer)
+  {
+    //"self" becomes the MM wrapper of "parent"; glibmm deletes it when "parent" is finalized
+    instance->self = new DerivedCppType(&instance->head.parent);
+    instance->head.object = instance->self;
+  }
+
+  static DerivedCppType* get(typename DerivedCppType::BaseObjectType* gobj)
+  {
+    return reinterpret_cast<MMInstance*>(gobj)->self;
+  }
+};
+
+template<class DerivedCppType>
+const char* MMInstance<DerivedCppType, false>::type_name = 0;
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/** Gets the C++ object of @a gobj, an instance of a type registered with
+ * register_mm_type() or register_mm_tracer() for @a DerivedCppType, or of a
+ * GType derived from it.  Unlike Glib::wrap() and a dynamic_cast, this does
+ * not look the object up: it is read at a fixed offset from @a gobj, so C
+ * callbacks of an element, such as pad functions set with the C API, can
+ * reach it without a lookup.
+ */
+template<class DerivedCppType>
+inline DerivedCppType*
+get_mm_instance(typename DerivedCppType::BaseObjectType* gobj)
+{
+  return MMInstance<DerivedCppType>::get(gobj);
+}
+
 template<class DerivedCppType>
 static GType
 register_mm_type(const gchar * type_name=typeid(DerivedCppType).name());
@@ -60,16 +174,8 @@ template<class DerivedCppType>
 static GType
 register_mm_type(const gchar * type_name=typeid(DerivedCppType).name())
 {
-    struct GlibCppType
+    struct GlibCppType : public MMInstance<DerivedCppType>
     {
-        typename DerivedCppType::BaseObjectType parent;
-        DerivedCppType *self;
-        static void init(GlibCppType *instance, gpointer g_class)
-        {
-            //instance->parent will be passed to C++ base of DerivedCppType; this will cause registerging "self" as MM wrapper of "parent"
-            instance->self = new DerivedCppType(&instance->parent);
-
-        }
         static void base_init(typename DerivedCppType::BaseClassType *klass)
         {
             Gst::ElementClass<DerivedCppType> element_class(klass);
@@ -77,7 +183,7 @@ register_mm_type(const gchar * type_name=typeid(DerivedCppType).name())
         }
         static void finalize(GObject *object)
         {
-            //the following will destroy q_data, among which MM wrapper to this "object" is stored. This will cause implicit delete on "self", since it is registered as wrapper of "object".
+            //the following will destroy q_data, among which MM wrapper to this "object" is stored. This will cause implicit delete on the C++ object, since it is registered as wrapper of "object".
             (G_OBJECT_CLASS(g_type_class_peek_parent(G_OBJECT_GET_CLASS(object))))->finalize(object);
         }
     };
@@ -127,6 +233,72 @@ register_mm_type(const gchar * type_name=typeid(DerivedCppType).name())
         info.value_table = 0;
 
         GType _type = g_type_register_static(parent_type, type_name, &info, (GTypeFlags)0);
+        MMInstance<DerivedCppType>::type_name = g_type_name(_type);
+        g_once_init_leave(&gonce_data, (gsize) _type);
+    }
+    return (GType) gonce_data;
+}
+
+/** Registers the C++ tracer type @a DerivedCppType, derived from
+ * Gst::Tracer, like register_mm_type() registers an element type.  Every
+ * instance of the returned GType constructs a @a DerivedCppType from its C
+ * instance, so the tracer can be created by gstreamer, for example when it is
+ * enabled with the GST_TRACERS environment variable, as well as with
+ * Gst::Tracer::create().  @a DerivedCppType needs a constructor taking a
+ * GstTracer*.  As with register_mm_type(), the C++ object is usually kept
+ * inside the C instance; its Glib::ObjectBase is then constructed with
+ * @a type_name, not by the constructor of @a DerivedCppType.
+ * @param type_name The name of the type.
+ * @return The GType of the tracer.
+ */
+template<class DerivedCppType>
+static GType
+register_mm_tracer(const gchar * type_name=typeid(DerivedCppType).name())
+{
+    struct GlibCppType : public MMInstance<DerivedCppType>
+    {
+        static void constructed(GObject *object)
+        {
+            GObjectClass *parent_class = G_OBJECT_CLASS(g_type_class_peek_parent(G_OBJECT_GET_CLASS(object)));
+            if (parent_class->constructed)
+                parent_class->constructed(object);
+            //the C++ object is complete now; the hooks it registered in its constructor may be called from the streaming threads
+            MMInstance<DerivedCppType>::get(reinterpret_cast<typename DerivedCppType::BaseObjectType*>(object))->_activate_hooks();
+        }
+        static void finalize(GObject *object)
+        {
+            (G_OBJECT_CLASS(g_type_class_peek_parent(G_OBJECT_GET_CLASS(object))))->finalize(object);
+        }
+    };
+
+    struct GlibCppTypeClass
+    {
+        typename DerivedCppType::BaseClassType parent_class;
+        static void init(GlibCppTypeClass * klass, gpointer data)
+        {
+            DerivedCppType::CppClassType::class_init_function((void*)klass, (void*)data);
+            G_OBJECT_CLASS(klass)->constructed = &GlibCppType::constructed;
+            G_OBJECT_CLASS(klass)->finalize = &GlibCppType::finalize;
+        }
+    };
+
+    static volatile gsize gonce_data = 0;
+    if (g_once_init_enter (&gonce_data)) {
+        GTypeInfo info;
+
+        info.class_size = sizeof(GlibCppTypeClass);
+        info.base_init = 0;
+        info.base_finalize = 0;
+        info.class_init = (GClassInitFunc) &GlibCppTypeClass::init;
+        info.class_finalize = 0;
+        info.class_data = 0;
+        info.instance_size = sizeof(GlibCppType);
+        info.n_preallocs = 0;
+        info.instance_init = (GInstanceInitFunc) &GlibCppType::init;
+        info.value_table = 0;
+
+        GType _type = g_type_register_static(DerivedCppType::get_base_type(), type_name, &info, (GTypeFlags)0);
+        MMInstance<DerivedCppType>::type_name = g_type_name(_type);
         g_once_init_leave(&gonce_data, (gsize) _type);
     }
     return (GType) gonce_data;
@@ -0,0 +1,111 @@
+/* gstreamermm - a C++ wrapper for gstreamer
+ *
+ * Copyright 2008 The gstreamermm Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free
+ * Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _GSTREAMERMM_SPAN_H
+#define _GSTREAMERMM_SPAN_H
+
+#include <glib.h>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Gst
+{
+
+/** A non-owning view over a contiguous sequence of elements.
+ * A Span is a pointer and an element count.  It is used to hand out memory
+ * owned by gstreamer (mapped buffers, peeked data, ring buffer segments)
+ * without copying it.  The viewed memory must outlive the Span.
+ *
+ * A Span<T> converts implicitly to a Span<const T>.
+ */
+template <class T>
+class Span
+{
+public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef T* pointer;
+  typedef T& reference;
+
+  Span()
+  : data_(0),
+    size_(0)
+  {}
+
+  /** Creates a view of @a size elements starting at @a data.
+   */
+  Span(T* data, gsize size)
+  : data_(data),
+    size_(size)
+  {}
+
+  template <class U>
+  Span(const Span<U>& other,
+    typename std::enable_if<std::is_convertible<U*, T*>::value>::type* = 0)
+  : data_(other.data()),
+    size_(other.size())
+  {}
+
+  T* data() const { return data_; }
+
+  /** Gets the number of elements in the view.
+   */
+  gsize size() const { return size_; }
+
+  /** Gets the size of the view in bytes.
+   */
+  gsize size_bytes() const { return size_ * sizeof(T); }
+
+  bool empty() const { return size_ == 0; }
+
+  T* begin() const { return data_; }
+  T* end() const { return data_ + size_; }
+
+  T& operator[](gsize idx) const { return data_[idx]; }
+
+  /** Gets the element at @a idx.
+   * @throw std::out_of_range if @a idx is not smaller than size().
+   */
+  T& at(gsize idx) const
+  {
+    if(idx >= size_)
+      throw std::out_of_range("Gst::Span::at(): index out of range.");
+    return data_[idx];
+  }
+
+  /** Gets a view of @a count elements starting at @a offset.  The result is
+   * clamped to the end of this view.
+   */
+  Span subspan(gsize offset, gsize count = G_MAXSIZE) const
+  {
+    if(offset > size_)
+      offset = size_;
+    if(count > size_ - offset)
+      count = size_ - offset;
+    return Span(data_ + offset, count);
+  }
+
+private:
+  T* data_;
+  gsize size_;
+};
+
+} // namespace Gst
+
+#endif //_GSTREAMERMM_SPAN_H
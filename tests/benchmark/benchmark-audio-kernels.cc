@@ -0,0 +1,174 @@
+/*
+ * benchmark-audio-kernels.cc
+ *
+ * Measures each Gst::AudioKernels kernel with the scalar implementation and
+ * with the best instruction set of the CPU.  The buffers fit in the L2
+ * cache, so that the kernels and not the memory are measured.
+ *
+ * Usage: benchmark-audio-kernels [iterations]
+ */
+
+#include <gstreamermm.h>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace Gst;
+
+namespace
+{
+
+const gsize frames = 4096;
+const guint channels = 2;
+const gsize samples = frames * channels;
+
+std::vector<gint16> s16(samples);
+std::vector<gint32> s32(samples);
+std::vector<guint8> s24(samples * 3);
+std::vector<float> interleaved(samples);
+std::vector<float> left(frames);
+std::vector<float> right(frames);
+std::vector<float> mixed(frames);
+
+Span<guint8> bytes(void* data, gsize size)
+{
+    return Span<guint8>(static_cast<guint8*>(data), size);
+}
+
+void unpack_s16()
+{
+    AudioKernels::unpack_f32(AUDIO_FORMAT_S16LE, bytes(&s16[0], samples * 2), Span<float>(&interleaved[0], samples));
+}
+
+void pack_s16()
+{
+    AudioKernels::pack_f32(AUDIO_FORMAT_S16LE, Span<float>(&interleaved[0], samples), bytes(&s16[0], samples * 2));
+}
+
+void unpack_s32()
+{
+    AudioKernels::unpack_f32(AUDIO_FORMAT_S32LE, bytes(&s32[0], samples * 4), Span<float>(&interleaved[0], samples));
+}
+
+void pack_s32()
+{
+    AudioKernels::pack_f32(AUDIO_FORMAT_S32LE, Span<float>(&interleaved[0], samples), bytes(&s32[0], samples * 4));
+}
+
+void unpack_s24()
+{
+    AudioKernels::unpack_f32(AUDIO_FORMAT_S24LE, bytes(&s24[0], s24.size()), Span<float>(&interleaved[0], samples));
+}
+
+void pack_s24()
+{
+    AudioKernels::pack_f32(AUDIO_FORMAT_S24LE, Span<float>(&interleaved[0], samples), bytes(&s24[0], s24.size()));
+}
+
+void interleave()
+{
+    const float* planes[] = { &left[0], &right[0] };
+    AudioKernels::interleave(planes, channels, Span<float>(&interleaved[0], samples));
+}
+
+void deinterleave()
+{
+    float* planes[] = { &left[0], &right[0] };
+    AudioKernels::deinterleave(Span<float>(&interleaved[0], samples), channels, planes);
+}
+
+void apply_gain()
+{
+    AudioKernels::apply_gain(Span<float>(&interleaved[0], samples), 0.999f);
+}
+
+void mix()
+{
+    const float* planes[] = { &left[0], &right[0] };
+    const float gains[] = { 0.5f, 0.5f };
+    AudioKernels::mix(planes, gains, channels, Span<float>(&mixed[0], frames));
+}
+
+// Returns the time per sample in nanoseconds.
+double run(void (*kernel)(), guint64 iterations)
+{
+    kernel();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (guint64 i = 0; i < iterations; i++)
+        kernel();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / (iterations * samples);
+}
+
+const char* name(AudioKernels::InstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+    case AudioKernels::INSTRUCTION_SET_SSE2:
+        return "SSE2";
+    case AudioKernels::INSTRUCTION_SET_AVX2:
+        return "AVX2";
+    case AudioKernels::INSTRUCTION_SET_NEON:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Gst::init(argc, argv);
+
+    guint64 iterations = argc > 1 ? std::strtoull(argv[1], 0, 10) : 10000;
+    if (!iterations)
+        iterations = 1;
+
+    for (gsize i = 0; i < samples; i++)
+        interleaved[i] = (i % 200) / 100.0f - 1.0f;
+    pack_s16();
+    pack_s32();
+    pack_s24();
+    deinterleave();
+
+    struct
+    {
+        const char* name;
+        void (*kernel)();
+    } const kernels[] =
+    {
+        { "unpack S16 to F32", &unpack_s16 },
+        { "pack F32 to S16", &pack_s16 },
+        { "unpack S32 to F32", &unpack_s32 },
+        { "pack F32 to S32", &pack_s32 },
+        { "unpack S24 to F32", &unpack_s24 },
+        { "pack F32 to S24", &pack_s24 },
+        { "interleave", &interleave },
+        { "deinterleave", &deinterleave },
+        { "apply gain", &apply_gain },
+        { "mix", &mix }
+    };
+
+    const AudioKernels::InstructionSet best = AudioKernels::get_instruction_set();
+    std::cout << std::setw(20) << std::left << "ns/sample" << std::setw(10) << std::right << "scalar"
+              << std::setw(10) << name(best) << std::setw(10) << "speedup" << std::endl;
+
+    for (gsize i = 0; i < G_N_ELEMENTS(kernels); i++)
+    {
+        AudioKernels::set_instruction_set(AudioKernels::INSTRUCTION_SET_SCALAR);
+        const double scalar_time = run(kernels[i].kernel, iterations);
+        AudioKernels::set_instruction_set(best);
+        const double best_time = run(kernels[i].kernel, iterations);
+
+        std::cout << std::setw(20) << std::left << kernels[i].name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << scalar_time << std::setw(10) << best_time
+                  << std::setw(9) << std::setprecision(1) << scalar_time / best_time << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * benchmark-pad-chain.cc
+ *
+ * Measures the cost of pushing a buffer into a pad whose chain function is
+ * a Gst::Pad slot, compared with a plain C chain function.  The same buffer
+ * is pushed again and again, so that only the dispatch is measured.
+ *
+ * Usage: benchmark-pad-chain [iterations]
+ */
+
+#include <gstreamermm.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Gst;
+
+namespace
+{
+
+guint64 received = 0;
+
+GstFlowReturn c_chain(GstPad*, GstObject*, GstBuffer* buffer)
+{
+    received++;
+    gst_buffer_unref(buffer);
+    return GST_FLOW_OK;
+}
+
+FlowReturn cxx_chain(const Glib::RefPtr<Pad>&, Glib::RefPtr<Buffer>&)
+{
+    received++;
+    return FLOW_OK;
+}
+
+double run(const Glib::RefPtr<Pad>& src, const Glib::RefPtr<Pad>& sink, guint64 iterations)
+{
+    src->link(sink);
+    sink->set_active(true);
+    src->set_active(true);
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("benchmark"));
+    src->push_event(EventNewSegment::create(segment));
+
+    GstBuffer* buffer = gst_buffer_new_allocate(0, 64, 0);
+    received = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (guint64 i = 0; i < iterations; i++)
+        gst_pad_push(src->gobj(), gst_buffer_ref(buffer));
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    gst_buffer_unref(buffer);
+    src->set_active(false);
+    sink->set_active(false);
+
+    if (received != iterations)
+        std::cerr << "only " << received << " of " << iterations << " buffers arrived" << std::endl;
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Gst::init(argc, argv);
+
+    guint64 iterations = argc > 1 ? std::strtoull(argv[1], 0, 10) : 1000000;
+    if (!iterations)
+        iterations = 1;
+
+    Glib::RefPtr<Pad> c_sink = Pad::create("sink", PAD_SINK);
+    gst_pad_set_chain_function(c_sink->gobj(), &c_chain);
+    double c_time = run(Pad::create("src", PAD_SRC), c_sink, iterations);
+
+    Glib::RefPtr<Pad> cxx_sink = Pad::create("sink", PAD_SINK);
+    cxx_sink->set_chain_function(sigc::ptr_fun(&cxx_chain));
+    double cxx_time = run(Pad::create("src", PAD_SRC), cxx_sink, iterations);
+
+    std::cout << "C chain function:    " << c_time << " ns/buffer" << std::endl;
+    std::cout << "Gst::Pad slot:       " << cxx_time << " ns/buffer" << std::endl;
+    std::cout << "overhead:            " << cxx_time - c_time << " ns/buffer" << std::endl;
+
+    return 0;
+}
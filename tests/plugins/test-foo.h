@@ -34,10 +34,10 @@ public:
     {
         buf = buf->create_writable();
         assert(buf->gobj()->mini_object.refcount==1);
-        Glib::RefPtr<Gst::MapInfo> mapinfo(new Gst::MapInfo());
-        buf->map(mapinfo, Gst::MAP_WRITE);
-        std::sort(mapinfo->get_data(), mapinfo->get_data() + mapinfo->get_size());
-        buf->unmap(mapinfo);
+        {
+            Gst::MappedBuffer<Gst::MAP_WRITE> mapped(buf);
+            std::sort(mapped.begin(), mapped.end());
+        }
         assert(buf->gobj()->mini_object.refcount==1);
         return srcpad->push(buf);
     }
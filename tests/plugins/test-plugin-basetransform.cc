@@ -0,0 +1,187 @@
+/*
+ * test-plugin-basetransform.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <gstreamermm/appsink.h>
+#include <gstreamermm/appsrc.h>
+#include <gstreamermm/private/basetransform_p.h>
+#include <vector>
+
+using namespace Gst;
+using Glib::RefPtr;
+
+// Outputs buffers twice as large as its input, allocated by the base class.
+class Doubler : public Gst::BaseTransform
+{
+public:
+    static void base_init(Gst::ElementClass<Doubler> *klass)
+    {
+        klass->set_metadata("doubler_longname",
+                "doubler_classification", "doubler_detail_description", "doubler_detail_author");
+
+        klass->add_pad_template(Gst::PadTemplate::create(SINK_NAME, Gst::PAD_SINK, Gst::PAD_ALWAYS,
+                        Gst::Caps::create_any()));
+        klass->add_pad_template(Gst::PadTemplate::create(SRC_NAME, Gst::PAD_SRC, Gst::PAD_ALWAYS,
+                        Gst::Caps::create_any()));
+    }
+
+    explicit Doubler(GstBaseTransform *gobj)
+        : Gst::BaseTransform(gobj)
+    {
+    }
+
+    bool transform_size_vfunc(PadDirection direction, const RefPtr<Caps>&, gsize size, const RefPtr<Caps>&, gsize& othersize) const
+    {
+        othersize = direction == PAD_SINK ? size * 2 : size / 2;
+        return true;
+    }
+
+    FlowReturn transform_vfunc(const RefPtr<Buffer>& inbuf, const RefPtr<Buffer>& outbuf)
+    {
+        if (outbuf->get_size() != 2 * inbuf->get_size())
+            return FLOW_ERROR;
+
+        // The output buffer is writable.
+        return outbuf->memset(0, 0xab, outbuf->get_size()) == outbuf->get_size() ? FLOW_OK : FLOW_ERROR;
+    }
+};
+
+// Outputs one buffer for every BATCH input buffers, sharing their memory.
+class Batcher : public Gst::BaseTransform
+{
+    std::vector< RefPtr<Buffer> > pending;
+
+public:
+    static const guint BATCH = 3;
+
+    static void base_init(Gst::ElementClass<Batcher> *klass)
+    {
+        klass->set_metadata("batcher_longname",
+                "batcher_classification", "batcher_detail_description", "batcher_detail_author");
+
+        klass->add_pad_template(Gst::PadTemplate::create(SINK_NAME, Gst::PAD_SINK, Gst::PAD_ALWAYS,
+                        Gst::Caps::create_any()));
+        klass->add_pad_template(Gst::PadTemplate::create(SRC_NAME, Gst::PAD_SRC, Gst::PAD_ALWAYS,
+                        Gst::Caps::create_any()));
+    }
+
+    explicit Batcher(GstBaseTransform *gobj)
+        : Gst::BaseTransform(gobj)
+    {
+    }
+
+    FlowReturn submit_input_buffer_vfunc(bool, RefPtr<Buffer>& input)
+    {
+        pending.push_back(input);
+        input.reset();
+        return FLOW_OK;
+    }
+
+    FlowReturn generate_output_vfunc(RefPtr<Buffer>& output)
+    {
+        if (pending.size() < BATCH)
+            return FLOW_OK;
+
+        output = Buffer::create(0);
+        for (guint i = 0; i < pending.size(); i++)
+            output->append(pending[i]);
+        pending.clear();
+        return FLOW_OK;
+    }
+};
+
+bool register_doubler(Glib::RefPtr<Gst::Plugin> plugin)
+{
+    Gst::ElementFactory::register_element(plugin, "doublermm", 10, Gst::register_mm_type<Doubler>("doublermm"));
+    Gst::ElementFactory::register_element(plugin, "batchermm", 10, Gst::register_mm_type<Batcher>("batchermm"));
+    return true;
+}
+
+class BaseTransformPluginTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        Plugin::register_static(GST_VERSION_MAJOR, GST_VERSION_MINOR, "doubler",
+              "doubler is example of C++ transform", sigc::ptr_fun(register_doubler), "0.123",
+              "LGPL", "source?", "package?", "http://example.com");
+    }
+};
+
+TEST_F(BaseTransformPluginTest, OutputIsAllocatedWithTransformSize)
+{
+    RefPtr<Pipeline> pipeline = Pipeline::create();
+    RefPtr<AppSrc> source = RefPtr<AppSrc>::cast_dynamic(ElementFactory::create_element("appsrc", "source"));
+    RefPtr<Element> doubler = ElementFactory::create_element("doublermm", "doubler");
+    RefPtr<AppSink> sink = RefPtr<AppSink>::cast_dynamic(ElementFactory::create_element("appsink", "sink"));
+
+    ASSERT_TRUE(source);
+    ASSERT_TRUE(doubler);
+    ASSERT_TRUE(sink);
+
+    source->set_property("caps", Caps::create_from_string("x-application/x-test"));
+    ASSERT_NO_THROW(pipeline->add(source)->add(doubler)->add(sink));
+    ASSERT_NO_THROW(source->link(doubler)->link(sink));
+
+    pipeline->set_state(STATE_PLAYING);
+
+    RefPtr<Buffer> input = Buffer::create(8);
+    source->push_buffer(input);
+
+    RefPtr<Sample> sample = sink->pull_sample();
+    ASSERT_TRUE(sample);
+    RefPtr<Buffer> buffer = sample->get_buffer();
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(16u, buffer->get_size());
+
+    source->end_of_stream();
+
+    RefPtr<Message> msg = pipeline->get_bus()->poll((MessageType)(MESSAGE_EOS | MESSAGE_ERROR), 1*SECOND);
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(MESSAGE_EOS, msg->get_message_type());
+
+    pipeline->set_state(STATE_NULL);
+}
+
+TEST_F(BaseTransformPluginTest, BatchInputBuffers)
+{
+    RefPtr<Pipeline> pipeline = Pipeline::create();
+    RefPtr<AppSrc> source = RefPtr<AppSrc>::cast_dynamic(ElementFactory::create_element("appsrc", "source"));
+    RefPtr<Element> batcher = ElementFactory::create_element("batchermm", "batcher");
+    RefPtr<AppSink> sink = RefPtr<AppSink>::cast_dynamic(ElementFactory::create_element("appsink", "sink"));
+
+    ASSERT_TRUE(source);
+    ASSERT_TRUE(batcher);
+    ASSERT_TRUE(sink);
+
+    source->set_property("caps", Caps::create_from_string("x-application/x-test"));
+    ASSERT_NO_THROW(pipeline->add(source)->add(batcher)->add(sink));
+    ASSERT_NO_THROW(source->link(batcher)->link(sink));
+
+    pipeline->set_state(STATE_PLAYING);
+
+    for (guint i = 0; i < 2 * Batcher::BATCH; i++)
+    {
+        RefPtr<Buffer> input = Buffer::create(4);
+        source->push_buffer(input);
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        RefPtr<Sample> sample = sink->pull_sample();
+        ASSERT_TRUE(sample);
+        RefPtr<Buffer> buffer = sample->get_buffer();
+        ASSERT_TRUE(buffer);
+        EXPECT_EQ(4u * Batcher::BATCH, buffer->get_size());
+    }
+
+    source->end_of_stream();
+
+    RefPtr<Message> msg = pipeline->get_bus()->poll((MessageType)(MESSAGE_EOS | MESSAGE_ERROR), 1*SECOND);
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(MESSAGE_EOS, msg->get_message_type());
+
+    pipeline->set_state(STATE_NULL);
+}
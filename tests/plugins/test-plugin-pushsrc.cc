@@ -62,9 +62,80 @@ public:
     }
 };
 
+// Counts the buffers it allocates.
+class CountingBufferPool : public Gst::BufferPool
+{
+public:
+    int allocated;
+
+    CountingBufferPool()
+    : allocated(0)
+    {}
+
+    Gst::FlowReturn alloc_buffer_vfunc(RefPtr<Gst::Buffer>& buffer)
+    {
+        allocated++;
+        return Gst::BufferPool::alloc_buffer_vfunc(buffer);
+    }
+};
+
+// Fills buffers acquired from a pool, and checks that they are recycled.
+class PoolSrc : public Gst::PushSrc
+{
+public:
+    static const int COUNT = 50;
+    static const int WARM_UP = 10;
+
+    RefPtr<CountingBufferPool> pool;
+    int filled;
+    int pooled;
+    int allocated_at_warm_up;
+
+    static void base_init(Gst::ElementClass<PoolSrc> *klass)
+    {
+        klass->set_metadata("poolsrc_longname",
+                "poolsrc_classification", "poolsrc_detail_description", "poolsrc_detail_author");
+
+        klass->add_pad_template(Gst::PadTemplate::create("src", Gst::PAD_SRC, Gst::PAD_ALWAYS,
+                                                     Gst::Caps::create_from_string("x-application/x-foo1")));
+    }
+
+    explicit PoolSrc(GstPushSrc *gobj)
+        : Gst::PushSrc(gobj),
+          pool(new CountingBufferPool()),
+          filled(0),
+          pooled(0),
+          allocated_at_warm_up(0)
+    {
+        set_blocksize(64);
+    }
+
+    bool decide_allocation_vfunc(Gst::QueryAllocation& query)
+    {
+        // Downstream proposes no pool, bring our own.
+        if (query.get_n_allocation_pools() == 0)
+            query.add_allocation_pool(pool, get_blocksize(), 2, 0);
+
+        return Gst::PushSrc::decide_allocation_vfunc(query);
+    }
+
+    Gst::FlowReturn fill_vfunc(Gst::Buffer& buffer)
+    {
+        if (buffer.gobj()->pool)
+            pooled++;
+        if (filled == WARM_UP)
+            allocated_at_warm_up = pool->allocated;
+
+        filled++;
+        buffer.memset(0, guint8(filled), buffer.get_size());
+        return Gst::FLOW_OK;
+    }
+};
+
 bool register_foo(Glib::RefPtr<Gst::Plugin> plugin)
 {
     Gst::ElementFactory::register_element(plugin, "foosrcmm", 10, Gst::register_mm_type<FooSrc>("foosrcmm"));
+    Gst::ElementFactory::register_element(plugin, "poolsrcmm", 10, Gst::register_mm_type<PoolSrc>("poolsrcmm"));
     return true;
 
 }
@@ -109,3 +180,31 @@ TEST_F(PushSrcPluginTest, DISABLED_CreatePipelineWithRegisteredElement)
 {
     CreatePipeline();
 }
+
+TEST_F(PushSrcPluginTest, FillRecyclesPoolBuffers)
+{
+    RefPtr<Pipeline> pipeline = Pipeline::create("pool-pipeline");
+    RefPtr<Element> source = ElementFactory::create_element("poolsrcmm", "src");
+    RefPtr<Element> sink = ElementFactory::create_element("fakesink", "sink");
+
+    ASSERT_TRUE(source);
+    ASSERT_TRUE(sink);
+
+    source->set_property("num-buffers", int(PoolSrc::COUNT));
+    pipeline->add(source)->add(sink);
+    source->link(sink);
+
+    pipeline->set_state(STATE_PLAYING);
+    RefPtr<Message> message = pipeline->get_bus()->pop(CLOCK_TIME_NONE, MESSAGE_EOS | MESSAGE_ERROR);
+    ASSERT_TRUE(message);
+    EXPECT_EQ(MESSAGE_EOS, message->get_message_type());
+    pipeline->set_state(STATE_NULL);
+
+    RefPtr<PoolSrc> pool_src = RefPtr<PoolSrc>::cast_dynamic(source);
+    ASSERT_TRUE(pool_src);
+    EXPECT_EQ(PoolSrc::COUNT, pool_src->filled);
+    EXPECT_EQ(PoolSrc::COUNT, pool_src->pooled);
+    // No buffer was allocated after the warm-up.
+    EXPECT_LT(0, pool_src->allocated_at_warm_up);
+    EXPECT_EQ(pool_src->allocated_at_warm_up, pool_src->pool->allocated);
+}
@@ -54,6 +54,52 @@ TEST_F(RegisterPluginTest, CreateRegisteredElement)
     ASSERT_TRUE(filter);
 }
 
+TEST_F(RegisterPluginTest, ElementIsConstructedInPlace)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        filter = Gst::ElementFactory::create_element("foomm", "filter");
+        ASSERT_TRUE(filter);
+
+        Foo* foo = dynamic_cast<Foo*>(filter.operator->());
+        ASSERT_TRUE(foo);
+        ASSERT_EQ(filter->gobj(), foo->gobj());
+
+        // The C++ object lives inside the C instance.
+        GTypeQuery query;
+        g_type_query(G_OBJECT_TYPE(filter->gobj()), &query);
+        const guint8* instance = reinterpret_cast<const guint8*>(filter->gobj());
+        const guint8* object = reinterpret_cast<const guint8*>(foo);
+        ASSERT_TRUE(object >= instance + sizeof(GstElement));
+        ASSERT_TRUE(object + sizeof(Foo) <= instance + query.instance_size);
+    }
+}
+
+TEST_F(RegisterPluginTest, WrapperResolvesToRegisteredType)
+{
+    filter = Gst::ElementFactory::create_element("foomm", "filter");
+    ASSERT_TRUE(filter);
+    GstElement* gobj = filter->gobj();
+
+    // The object constructed in place is named after the GType, not after
+    // Foo, and is still found as a Foo.
+    Foo* foo = get_mm_instance<Foo>(gobj);
+    ASSERT_TRUE(foo);
+    EXPECT_EQ(gobj, foo->gobj());
+
+    RefPtr<Element> wrapped = Glib::wrap(gobj, true);
+    EXPECT_EQ(filter, wrapped);
+    EXPECT_EQ(foo, dynamic_cast<Foo*>(wrapped.operator->()));
+    EXPECT_EQ(foo, RefPtr<Foo>::cast_dynamic(wrapped).operator->());
+
+    Glib::ObjectBase* base = Glib::ObjectBase::_get_current_wrapper(G_OBJECT(gobj));
+    EXPECT_EQ(foo, dynamic_cast<Foo*>(base));
+
+    // The generated vfunc callbacks only call the C++ vfuncs of derived
+    // objects.
+    EXPECT_TRUE(base->is_derived_());
+}
+
 TEST_F(RegisterPluginTest, CheckPropertyUsage)
 {
     filter = Gst::ElementFactory::create_element("foomm", "filter");
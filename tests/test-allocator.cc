@@ -0,0 +1,127 @@
+/*
+ * test-allocator.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <unistd.h>
+
+using namespace Gst;
+using Glib::RefPtr;
+
+TEST(AllocatorTest, CheckDefaultAllocator)
+{
+    RefPtr<Allocator> allocator = Allocator::get_default();
+    ASSERT_TRUE(allocator);
+
+    RefPtr<Memory> memory = allocator->alloc(128);
+    ASSERT_TRUE(memory);
+    ASSERT_EQ(128u, memory->get_size());
+}
+
+TEST(AllocatorTest, CheckAlignedAllocator)
+{
+    RefPtr<AlignedAllocator> allocator = AlignedAllocator::create(256);
+    ASSERT_EQ(256u, allocator->get_alignment());
+
+    AllocationParams params(MemoryFlags(0), 0, 16, 16);
+    RefPtr<Memory> memory = allocator->alloc(1000, params);
+    ASSERT_TRUE(memory);
+    ASSERT_EQ(1000u, memory->get_size());
+    ASSERT_EQ(16u, memory->get_offset());
+
+    MappedMemory<MAP_WRITE> mapped(memory);
+    ASSERT_EQ(0u, (reinterpret_cast<guintptr>(mapped.data()) - 16) % 256);
+    mapped[0] = 42;
+    mapped[999] = 43;
+}
+
+TEST(AllocatorTest, CheckSharedMemoryKeepsRegion)
+{
+    RefPtr<AlignedAllocator> allocator = AlignedAllocator::create();
+    RefPtr<Memory> memory = allocator->alloc(64);
+    {
+        MappedMemory<MAP_WRITE> mapped(memory);
+        for (gsize i = 0; i < mapped.size(); i++)
+            mapped[i] = i;
+    }
+
+    RefPtr<Memory> shared = Glib::wrap(gst_memory_share(memory->gobj(), 8, 16));
+    memory.reset();
+    ASSERT_TRUE(shared);
+    ASSERT_EQ(16u, shared->get_size());
+
+    MappedMemory<MAP_READ> mapped(shared);
+    ASSERT_EQ(8, mapped[0]);
+    ASSERT_EQ(23, mapped[15]);
+}
+
+TEST(AllocatorTest, CheckHugePageAllocator)
+{
+    RefPtr<HugePageAllocator> allocator = HugePageAllocator::create();
+    RefPtr<Buffer> buffer = Buffer::create(1920 * 1080 * 4, allocator);
+    ASSERT_TRUE(buffer);
+    ASSERT_EQ(1920u * 1080 * 4, buffer->get_size());
+
+    RefPtr<Memory> memory = buffer->get_memory(0);
+    ASSERT_EQ(0u, reinterpret_cast<guintptr>(MappedMemory<MAP_READ>(memory).data()) % HugePageAllocator::huge_page_size);
+
+    MappedBuffer<MAP_WRITE, guint32> pixels(buffer);
+    std::fill(pixels.begin(), pixels.end(), 0xff00ff00);
+}
+
+TEST(AllocatorTest, CheckMemfdAllocator)
+{
+    RefPtr<MemfdAllocator> allocator = MemfdAllocator::create();
+    RefPtr<Memory> memory = allocator->alloc(4096);
+    ASSERT_TRUE(memory);
+
+    {
+        MappedMemory<MAP_WRITE> mapped(memory);
+        mapped[0] = 'g';
+        mapped[1] = 's';
+        mapped[2] = 't';
+    }
+
+    const int fd = MemfdAllocator::get_fd(memory);
+    ASSERT_GE(fd, 0);
+
+    char data[3];
+    ASSERT_EQ(3, pread(fd, data, sizeof(data), memory->get_offset()));
+    ASSERT_EQ('g', data[0]);
+    ASSERT_EQ('t', data[2]);
+
+    ASSERT_EQ(-1, MemfdAllocator::get_fd(Allocator::get_default()->alloc(16)));
+}
+
+TEST(AllocatorTest, CheckRegisteredAllocator)
+{
+    RefPtr<AlignedAllocator> allocator = AlignedAllocator::create();
+    Allocator::register_allocator("gstreamermm-test-aligned", allocator);
+
+    ASSERT_EQ(RefPtr<Allocator>(allocator), Allocator::find("gstreamermm-test-aligned"));
+}
+
+TEST(AllocatorTest, CheckBufferPoolAllocator)
+{
+    RefPtr<AlignedAllocator> allocator = AlignedAllocator::create(128);
+    RefPtr<BufferPool> pool = BufferPool::create();
+
+    Structure config = pool->get_config();
+    BufferPool::config_set_params(config, Caps::create_simple("video/x-raw"), 4096, 1, 0);
+    BufferPool::config_set_allocator(config, allocator);
+    ASSERT_TRUE(pool->set_config(config));
+
+    RefPtr<Allocator> config_allocator;
+    AllocationParams params;
+    ASSERT_TRUE(BufferPool::config_get_allocator(pool->get_config(), config_allocator, params));
+    ASSERT_EQ(RefPtr<Allocator>(allocator), config_allocator);
+
+    ASSERT_TRUE(pool->set_active(true));
+    RefPtr<Buffer> buffer;
+    ASSERT_EQ(FLOW_OK, pool->acquire_buffer(buffer));
+    ASSERT_TRUE(gst_memory_is_type(buffer->get_memory(0)->gobj(), "GstmmAlignedMemory"));
+
+    buffer.reset();
+    ASSERT_TRUE(pool->set_active(false));
+}
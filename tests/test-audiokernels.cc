@@ -0,0 +1,255 @@
+/*
+ * test-audiokernels.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Gst;
+
+class AudioKernelsTest : public ::testing::Test
+{
+protected:
+    AudioKernels::InstructionSet best;
+    std::vector<float> samples;
+
+    virtual void SetUp()
+    {
+        best = AudioKernels::get_instruction_set();
+
+        // An odd count, so that the vector kernels also run their tails.
+        for (int i = 0; i < 1001; i++)
+            samples.push_back((i % 41) / 20.0f - 1.0f);
+        samples.push_back(1.0f);
+        samples.push_back(4.0f);
+        samples.push_back(-4.0f);
+    }
+
+    virtual void TearDown()
+    {
+        AudioKernels::set_instruction_set(best);
+    }
+
+    std::vector<gint16> pack_s16(AudioKernels::InstructionSet instruction_set)
+    {
+        AudioKernels::set_instruction_set(instruction_set);
+
+        std::vector<gint16> packed(samples.size());
+        Span<guint8> dest(reinterpret_cast<guint8*>(&packed[0]), packed.size() * sizeof(gint16));
+        EXPECT_EQ(samples.size(), AudioKernels::pack_f32(AUDIO_FORMAT_S16LE, Span<float>(&samples[0], samples.size()), dest));
+        return packed;
+    }
+
+    // The output of every kernel for one instruction set.
+    struct Outputs
+    {
+        std::vector<float> from_s16;
+        std::vector<gint16> to_s16;
+        std::vector<float> from_s32;
+        std::vector<gint32> to_s32;
+        std::vector<float> left;
+        std::vector<float> right;
+        std::vector<float> interleaved;
+        std::vector<float> scaled;
+        std::vector<float> mixed;
+    };
+
+    template <class T>
+    static Span<const guint8> input_bytes(const std::vector<T>& input, gsize offset)
+    {
+        return Span<const guint8>(reinterpret_cast<const guint8*>(&input[offset]), (input.size() - offset) * sizeof(T));
+    }
+
+    template <class T>
+    static Span<guint8> output_bytes(std::vector<T>& output, gsize offset)
+    {
+        return Span<guint8>(reinterpret_cast<guint8*>(&output[offset]), (output.size() - offset) * sizeof(T));
+    }
+
+    // Runs every kernel on the samples from offset on, so that the vector
+    // kernels load and store unaligned and run their tails.
+    Outputs run_kernels(AudioKernels::InstructionSet instruction_set, gsize offset)
+    {
+        EXPECT_EQ(instruction_set, AudioKernels::set_instruction_set(instruction_set));
+
+        const gsize size = samples.size();
+        const gsize count = size - offset;
+        const float* const src = &samples[offset];
+
+        std::vector<gint16> s16(size);
+        std::vector<gint32> s32(size);
+        for (gsize i = 0; i < size; i++)
+        {
+            s16[i] = static_cast<gint16>(static_cast<gint32>(i) * 65 - 32768);
+            s32[i] = static_cast<gint32>(static_cast<gint64>(i) * 4278255 - G_GINT64_CONSTANT(2147483648));
+        }
+        s16.back() = G_MAXINT16;
+        s32.back() = G_MAXINT32;
+
+        Outputs outputs;
+        outputs.from_s16.resize(size);
+        outputs.to_s16.resize(size);
+        outputs.from_s32.resize(size);
+        outputs.to_s32.resize(size);
+
+        EXPECT_EQ(count, AudioKernels::unpack_f32(AUDIO_FORMAT_S16LE, input_bytes(s16, offset), Span<float>(&outputs.from_s16[offset], count)));
+        EXPECT_EQ(count, AudioKernels::pack_f32(AUDIO_FORMAT_S16LE, Span<const float>(src, count), output_bytes(outputs.to_s16, offset)));
+        EXPECT_EQ(count, AudioKernels::unpack_f32(AUDIO_FORMAT_S32LE, input_bytes(s32, offset), Span<float>(&outputs.from_s32[offset], count)));
+        EXPECT_EQ(count, AudioKernels::pack_f32(AUDIO_FORMAT_S32LE, Span<const float>(src, count), output_bytes(outputs.to_s32, offset)));
+
+        outputs.left.resize(size);
+        outputs.right.resize(size);
+        outputs.interleaved.resize(size);
+        float* const planes[] = { &outputs.left[offset], &outputs.right[offset] };
+        AudioKernels::deinterleave(Span<const float>(src, count), 2, planes);
+        const float* const interleave_planes[] = { &outputs.left[offset], &outputs.right[offset] };
+        AudioKernels::interleave(interleave_planes, 2, Span<float>(&outputs.interleaved[offset], count));
+
+        outputs.scaled = samples;
+        AudioKernels::apply_gain(Span<float>(&outputs.scaled[offset], count), 0.75f);
+
+        std::vector<float> reversed(samples.rbegin(), samples.rend());
+        const float* const mix_planes[] = { src, &reversed[offset], &samples[0] };
+        const float gains[] = { 0.5f, -0.25f, 1.5f };
+        outputs.mixed.resize(size);
+        AudioKernels::mix(mix_planes, gains, 3, Span<float>(&outputs.mixed[offset], count));
+
+        return outputs;
+    }
+
+    // Compares float outputs, allowing for a multiply and add that the
+    // compiler fuses in one implementation and not in the other.
+    static ::testing::AssertionResult floats_match(const std::vector<float>& expected, const std::vector<float>& actual)
+    {
+        if (expected.size() != actual.size())
+            return ::testing::AssertionFailure() << "sizes differ";
+
+        for (gsize i = 0; i < expected.size(); i++)
+        {
+            if (std::fabs(expected[i] - actual[i]) > 1e-6f * std::max(1.0f, std::fabs(expected[i])))
+                return ::testing::AssertionFailure() << "sample " << i << ": " << expected[i] << " != " << actual[i];
+        }
+
+        return ::testing::AssertionSuccess();
+    }
+};
+
+TEST_F(AudioKernelsTest, S16RoundTrip)
+{
+    const std::vector<gint16> packed = pack_s16(best);
+    ASSERT_EQ(-32768, packed[0]);
+    ASSERT_EQ(32767, packed[samples.size() - 3]);
+    ASSERT_EQ(32767, packed[samples.size() - 2]);
+    ASSERT_EQ(-32768, packed[samples.size() - 1]);
+
+    std::vector<float> unpacked(packed.size());
+    Span<const guint8> src(reinterpret_cast<const guint8*>(&packed[0]), packed.size() * sizeof(gint16));
+    ASSERT_EQ(packed.size(), AudioKernels::unpack_f32(AUDIO_FORMAT_S16LE, src, Span<float>(&unpacked[0], unpacked.size())));
+
+    for (gsize i = 0; i < samples.size() - 3; i++)
+        ASSERT_NEAR(samples[i], unpacked[i], 1.0f / 32768);
+}
+
+TEST_F(AudioKernelsTest, VectorKernelsMatchScalarKernels)
+{
+    const AudioKernels::InstructionSet vector_sets[] =
+    {
+        AudioKernels::INSTRUCTION_SET_SSE2,
+        AudioKernels::INSTRUCTION_SET_AVX2,
+        AudioKernels::INSTRUCTION_SET_NEON
+    };
+
+    // samples holds an even count, so the offsets give both odd and even
+    // sample and frame counts.
+    for (gsize offset = 1; offset <= 3; offset++)
+    {
+        const Outputs scalar = run_kernels(AudioKernels::INSTRUCTION_SET_SCALAR, offset);
+
+        for (gsize i = 0; i < G_N_ELEMENTS(vector_sets); i++)
+        {
+            if (AudioKernels::set_instruction_set(vector_sets[i]) != vector_sets[i])
+                continue;
+
+            const Outputs vector = run_kernels(vector_sets[i], offset);
+            ASSERT_TRUE(floats_match(scalar.from_s16, vector.from_s16));
+            ASSERT_TRUE(scalar.to_s16 == vector.to_s16);
+            ASSERT_TRUE(floats_match(scalar.from_s32, vector.from_s32));
+            ASSERT_TRUE(scalar.to_s32 == vector.to_s32);
+            ASSERT_TRUE(floats_match(scalar.left, vector.left));
+            ASSERT_TRUE(floats_match(scalar.right, vector.right));
+            ASSERT_TRUE(floats_match(scalar.interleaved, vector.interleaved));
+            ASSERT_TRUE(floats_match(scalar.scaled, vector.scaled));
+            ASSERT_TRUE(floats_match(scalar.mixed, vector.mixed));
+        }
+    }
+}
+
+TEST_F(AudioKernelsTest, GenericFormatsUseGstreamerPacking)
+{
+    // 0.5 in S24LE, then -0.5 in S24LE.
+    const guint8 s24[] = { 0x00, 0x00, 0x40, 0x00, 0x00, 0xc0 };
+    float unpacked[3];
+
+    ASSERT_EQ(2u, AudioKernels::unpack_f32(AUDIO_FORMAT_S24LE, Span<const guint8>(s24, sizeof(s24)), Span<float>(unpacked, 3)));
+    ASSERT_FLOAT_EQ(0.5f, unpacked[0]);
+    ASSERT_FLOAT_EQ(-0.5f, unpacked[1]);
+
+    guint8 packed[6];
+    ASSERT_EQ(2u, AudioKernels::pack_f32(AUDIO_FORMAT_S24LE, Span<const float>(unpacked, 2), Span<guint8>(packed, sizeof(packed))));
+    ASSERT_EQ(0, memcmp(s24, packed, sizeof(s24)));
+
+    ASSERT_EQ(0u, AudioKernels::unpack_f32(AUDIO_FORMAT_UNKNOWN, Span<const guint8>(s24, sizeof(s24)), Span<float>(unpacked, 3)));
+}
+
+TEST_F(AudioKernelsTest, InterleaveAndMix)
+{
+    const gsize frames = samples.size() / 3;
+    std::vector<float> planes[3];
+    for (guint c = 0; c < 3; c++)
+        planes[c].assign(frames, 0.0f);
+
+    for (guint channels = 2; channels <= 3; channels++)
+    {
+        const gsize count = frames * channels;
+        float* dest[] = { &planes[0][0], &planes[1][0], &planes[2][0] };
+        AudioKernels::deinterleave(Span<float>(&samples[0], count), channels, dest);
+
+        std::vector<float> interleaved(count);
+        const float* src[] = { &planes[0][0], &planes[1][0], &planes[2][0] };
+        AudioKernels::interleave(src, channels, Span<float>(&interleaved[0], count));
+
+        for (gsize i = 0; i < count; i++)
+            ASSERT_EQ(samples[i], interleaved[i]);
+    }
+
+    const float* src[] = { &planes[0][0], &planes[1][0] };
+    const float gains[] = { 0.5f, -0.25f };
+    std::vector<float> mixed(frames);
+    AudioKernels::mix(src, gains, 2, Span<float>(&mixed[0], frames));
+    AudioKernels::apply_gain(Span<float>(&mixed[0], frames), 2.0f);
+
+    for (gsize i = 0; i < frames; i++)
+        ASSERT_FLOAT_EQ(planes[0][i] - 0.5f * planes[1][i], mixed[i]);
+}
+
+TEST_F(AudioKernelsTest, MixInPlace)
+{
+    const gsize frames = samples.size() / 2;
+    const float gains[] = { 0.5f, -0.25f };
+
+    std::vector<float> expected(frames);
+    const float* const src[] = { &samples[0], &samples[frames] };
+    AudioKernels::mix(src, gains, 2, Span<float>(&expected[0], frames));
+
+    // dest is the second plane, which is only added after the first one.
+    std::vector<float> mixed(samples.begin() + frames, samples.end());
+    const float* const in_place[] = { &samples[0], &mixed[0] };
+    AudioKernels::mix(in_place, gains, 2, Span<float>(&mixed[0], frames));
+
+    for (gsize i = 0; i < frames; i++)
+        ASSERT_FLOAT_EQ(expected[i], mixed[i]);
+}
@@ -0,0 +1,118 @@
+/*
+ * test-audioringbuffer.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <vector>
+
+using namespace Gst;
+using Glib::RefPtr;
+
+// 8 kHz mono S16, segments of 10 ms.
+const int segment_samples = 80;
+const int segment_bytes = 160;
+
+class SpscAudioRingBufferTest : public ::testing::Test
+{
+protected:
+    RefPtr<SpscAudioRingBuffer> ring_buffer;
+
+    virtual void SetUp()
+    {
+        RefPtr<Caps> caps = Caps::create_from_string(
+            "audio/x-raw, format=S16LE, layout=interleaved, rate=8000, channels=1");
+        AudioRingBufferSpec spec(caps, AUDIO_RING_BUFFER_FORMAT_TYPE_RAW, 10000, 40000);
+        ASSERT_TRUE(AudioRingBuffer::parse_caps(spec, caps));
+
+        ring_buffer = SpscAudioRingBuffer::create();
+        ASSERT_TRUE(ring_buffer->open_device());
+        ASSERT_TRUE(ring_buffer->acquire(spec));
+        ASSERT_EQ(segment_bytes, ring_buffer->gobj()->spec.segsize);
+        ASSERT_EQ(4, ring_buffer->gobj()->spec.segtotal);
+        ASSERT_TRUE(ring_buffer->activate(true));
+        ring_buffer->set_flushing(false);
+    }
+
+    virtual void TearDown()
+    {
+        ring_buffer->stop();
+        ring_buffer->activate(false);
+        ring_buffer->release();
+        ring_buffer->close_device();
+    }
+
+    guint commit(guint64& sample, int segments)
+    {
+        std::vector<guint8> data(segments * segment_bytes);
+        for(std::size_t i = 0; i < data.size(); i++)
+            data[i] = i / segment_bytes + 1;
+
+        int accum = 0;
+        const int samples = segments * segment_samples;
+        return ring_buffer->commit(sample, Span<const guint8>(&data[0], data.size()), samples, samples, accum);
+    }
+};
+
+TEST_F(SpscAudioRingBufferTest, DeviceReadsCommittedSegments)
+{
+    guint64 sample = 0;
+    ASSERT_EQ(2u * segment_samples, commit(sample, 2));
+    ASSERT_EQ(2u * segment_samples, sample);
+    ASSERT_EQ(2u, ring_buffer->get_queued_segments());
+
+    Span<const guint8> segment;
+    ASSERT_FALSE(ring_buffer->read_segment(segment));
+    ring_buffer->set_may_start(true);
+    ASSERT_TRUE(ring_buffer->start());
+
+    for(guint8 value = 1; value <= 2; value++)
+    {
+        ASSERT_TRUE(ring_buffer->read_segment(segment));
+        ASSERT_EQ(gsize(segment_bytes), segment.size());
+        ASSERT_EQ(value, segment[0]);
+        ASSERT_EQ(value, segment[segment_bytes - 1]);
+        ring_buffer->release_segment();
+    }
+
+    ASSERT_EQ(0u, ring_buffer->get_underrun_count());
+    ASSERT_EQ(2u * segment_samples, ring_buffer->get_samples_done());
+
+    // Nothing was committed for the third segment, it plays silence.
+    ASSERT_TRUE(ring_buffer->read_segment(segment));
+    ASSERT_EQ(0, segment[0]);
+    ring_buffer->release_segment();
+    ASSERT_EQ(1u, ring_buffer->get_underrun_count());
+}
+
+TEST_F(SpscAudioRingBufferTest, CommitStopsWhenFullBeforeStart)
+{
+    // One segment is kept free between the producer and the device, and the
+    // ring buffer may not start by itself.
+    guint64 sample = 0;
+    ASSERT_EQ(3u * segment_samples, commit(sample, 4));
+    ASSERT_EQ(3u * segment_samples, sample);
+    ASSERT_EQ(1u, ring_buffer->get_overrun_count());
+
+    ring_buffer->reset_counters();
+    ASSERT_EQ(0u, ring_buffer->get_overrun_count());
+}
+
+TEST_F(SpscAudioRingBufferTest, CommitIsLimitedToTheData)
+{
+    // Two segments are requested, but the data only holds one.
+    std::vector<guint8> data(segment_bytes, 1);
+    guint64 sample = 0;
+    int accum = 0;
+    ASSERT_EQ(guint(segment_samples), ring_buffer->commit(sample,
+        Span<const guint8>(&data[0], data.size()), 2 * segment_samples, 2 * segment_samples, accum));
+    ASSERT_EQ(guint64(segment_samples), sample);
+    ASSERT_EQ(1u, ring_buffer->get_queued_segments());
+}
+
+TEST_F(SpscAudioRingBufferTest, DelayIsMeasuredByTheDevice)
+{
+    ASSERT_EQ(0u, ring_buffer->get_delay());
+    ring_buffer->set_device_delay(40);
+    ASSERT_EQ(40u, ring_buffer->get_delay());
+}
@@ -127,3 +127,24 @@ TEST_F(BinTest, GetCorrectChildNumber)
 
     EXPECT_EQ(element_count, bin->get_num_children());
 }
+
+TEST_F(BinTest, GetPadStatistics)
+{
+    RefPtr<Element> src = AddElementToBin();
+    RefPtr<Element> sink = AddElementToBin("fakesink", "sink");
+    src->link(sink);
+
+    EXPECT_TRUE(bin->get_pad_statistics().empty());
+
+    bin->enable_pad_statistics();
+    EXPECT_TRUE(src->get_static_pad("src")->has_statistics());
+    EXPECT_TRUE(sink->get_static_pad("sink")->has_statistics());
+
+    std::vector<PadStatistics> statistics = bin->get_pad_statistics();
+    ASSERT_EQ(2u, statistics.size());
+    for (std::vector<PadStatistics>::iterator it = statistics.begin(); it != statistics.end(); ++it)
+    {
+        EXPECT_TRUE(it->pad);
+        EXPECT_EQ(0u, it->buffers);
+    }
+}
@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 #include <gstreamermm/buffer.h>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace Gst;
 
@@ -23,6 +26,156 @@ TEST(BufferTest, CheckBufferSize)
     buf->unmap(map_info);
 }
 
+TEST(BufferTest, CheckMappedBuffer)
+{
+    int buff_size = 23;
+    Glib::RefPtr<Buffer> buf = Buffer::create(buff_size);
+
+    {
+        MappedBuffer<MAP_WRITE> mapped(buf);
+
+        ASSERT_TRUE(mapped.is_mapped());
+        EXPECT_EQ(buff_size, mapped.size());
+        std::fill(mapped.begin(), mapped.end(), 7);
+    }
+
+    MappedBuffer<MAP_READ> mapped(buf);
+    MappedBuffer<MAP_READ> moved(std::move(mapped));
+
+    EXPECT_FALSE(mapped.is_mapped());
+    ASSERT_TRUE(moved.is_mapped());
+    EXPECT_EQ(buff_size, moved.size());
+    EXPECT_EQ(7, moved.data()[buff_size - 1]);
+
+    moved.unmap();
+    EXPECT_FALSE(moved.is_mapped());
+}
+
+TEST(BufferTest, CheckTypedMapping)
+{
+    Glib::RefPtr<Buffer> buf = Buffer::create(8 * sizeof(gint16));
+
+    {
+        MappedBuffer<MAP_WRITE, gint16> samples = buf->map_as<gint16, MAP_WRITE>();
+
+        ASSERT_EQ(8u, samples.size());
+        EXPECT_EQ(8 * sizeof(gint16), samples.size_bytes());
+        for (int i = 0; i < 8; i++)
+            samples[i] = -i;
+    }
+
+    MappedBuffer<MAP_READ, gint16> samples = buf->map_as<gint16>();
+    Span<const gint16> view = samples.get_span();
+
+    EXPECT_EQ(8u, view.size());
+    EXPECT_EQ(-7, view.at(7));
+    EXPECT_THROW(view.at(8), std::out_of_range);
+    EXPECT_EQ(2u, view.subspan(6).size());
+}
+
+TEST(BufferTest, CheckTypedMappingRejectsPartialElements)
+{
+    Glib::RefPtr<Buffer> buf = Buffer::create(7);
+
+    EXPECT_THROW(buf->map_as<gint32>(), std::runtime_error);
+
+    // The failed mapping must not leave the buffer mapped.
+    MappedBuffer<MAP_WRITE> mapped(buf);
+    EXPECT_EQ(7u, mapped.size());
+}
+
+TEST(BufferTest, CheckChunksOfMultiMemoryBuffer)
+{
+    Glib::RefPtr<Buffer> buf = Buffer::create(4);
+    gst_buffer_append_memory(buf->gobj(), gst_allocator_alloc(NULL, 6, NULL));
+    ASSERT_EQ(2u, buf->n_memory());
+
+    const guint8 data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(sizeof(data), buf->fill(0, data, sizeof(data)));
+
+    std::vector<gsize> sizes;
+    std::vector<guint8> bytes;
+    EXPECT_TRUE(buf->foreach_chunk([&](Span<const guint8> chunk)
+    {
+        sizes.push_back(chunk.size());
+        bytes.insert(bytes.end(), chunk.begin(), chunk.end());
+        return true;
+    }, 2, 5));
+
+    ASSERT_EQ(2u, sizes.size());
+    EXPECT_EQ(2u, sizes[0]);
+    EXPECT_EQ(3u, sizes[1]);
+    EXPECT_EQ(std::vector<guint8>(data + 2, data + 7), bytes);
+
+    // Iterating must not have merged the memory blocks.
+    EXPECT_EQ(2u, buf->n_memory());
+
+    guint8 extracted[3];
+    EXPECT_EQ(3u, buf->extract(3, extracted, 3));
+    EXPECT_EQ(0, buf->memcmp(3, extracted, 3));
+
+    Glib::RefPtr<Buffer> flat = Buffer::create(sizeof(data));
+    flat->fill(0, data, sizeof(data));
+    EXPECT_EQ(flat->get_checksum(Glib::Checksum::CHECKSUM_SHA1),
+        buf->get_checksum(Glib::Checksum::CHECKSUM_SHA1));
+}
+
+TEST(BufferTest, CheckWrappedVectorIsNotCopied)
+{
+    std::vector<guint8> data(16, 42);
+    const guint8* storage = data.data();
+
+    Glib::RefPtr<Buffer> buf = Buffer::create_wrapped(std::move(data));
+    ASSERT_TRUE(buf);
+
+    MappedBuffer<MAP_READ> mapped(buf);
+    EXPECT_EQ(storage, mapped.data());
+    EXPECT_EQ(16u, mapped.size());
+    EXPECT_EQ(42, mapped[15]);
+}
+
+TEST(BufferTest, CheckWrappedSharedContainerIsReleased)
+{
+    std::shared_ptr<std::string> data = std::make_shared<std::string>("shared payload");
+
+    Glib::RefPtr<Buffer> buf = Buffer::create_wrapped(data);
+    ASSERT_TRUE(buf);
+    EXPECT_EQ(2, data.use_count());
+    EXPECT_EQ(0, buf->memcmp(0, data->data(), data->size()));
+
+    buf.reset();
+    EXPECT_EQ(1, data.use_count());
+}
+
+TEST(BufferTest, CheckWrappedUniqueArray)
+{
+    std::unique_ptr<float[]> samples(new float[4]());
+    samples[3] = 0.5f;
+
+    Glib::RefPtr<Memory> mem = Memory::create_wrapped(std::move(samples), 4);
+    ASSERT_TRUE(mem);
+    EXPECT_FALSE(samples);
+
+    MappedMemory<MAP_READ, float> mapped = mem->map_as<float>();
+    EXPECT_EQ(4u, mapped.size());
+    EXPECT_EQ(0.5f, mapped[3]);
+}
+
+TEST(BufferTest, CheckTypedMappingUsesDeclaredAlignment)
+{
+    std::unique_ptr<gint32[]> samples(new gint32[4]());
+    Glib::RefPtr<Memory> mem = Memory::create_wrapped(std::move(samples), 4);
+    EXPECT_TRUE(mem->is_aligned_to(alignof(gint32)));
+    EXPECT_EQ(4u, mem->map_as<gint32>().size());
+
+    // Wrapped without a declared alignment, the data cannot be viewed as
+    // gint32, whatever its address.
+    gint32 data[4] = { 0 };
+    Glib::RefPtr<Memory> plain = Memory::create(MemoryFlags(0), data, sizeof(data), 0, sizeof(data));
+    EXPECT_THROW(plain->map_as<gint32>(), std::runtime_error);
+    EXPECT_EQ(sizeof(data), plain->map_as<guint8>().size());
+}
+
 TEST(BufferTest, CheckBufferFlags)
 {
     guint buff_flags = 1;
@@ -32,3 +185,113 @@ TEST(BufferTest, CheckBufferFlags)
 
     EXPECT_EQ(buff_flags, buf->get_flags());
 }
+
+TEST(BufferTest, CheckSliceSharesData)
+{
+    std::vector<guint8> data(64);
+    for (int i = 0; i < 64; i++)
+        data[i] = i;
+    const guint8* storage = data.data();
+
+    Glib::RefPtr<Buffer> buf = Buffer::create_wrapped(std::move(data));
+    buf->set_pts(1000);
+
+    Glib::RefPtr<Buffer> slice = buf->slice(16, 8);
+    ASSERT_TRUE(slice);
+    EXPECT_EQ(8u, slice->get_size());
+    EXPECT_EQ(1000u, slice->get_pts());
+
+    MappedBuffer<MAP_READ> mapped(slice);
+    EXPECT_EQ(storage + 16, mapped.data());
+    EXPECT_EQ(16, mapped[0]);
+
+    EXPECT_EQ(48u, buf->slice(16)->get_size());
+}
+
+TEST(BufferTest, CheckAppendAndMemoryRanges)
+{
+    Glib::RefPtr<Buffer> buf = Buffer::create_wrapped(std::string("head"));
+    Glib::RefPtr<Buffer> other = Buffer::create_wrapped(std::string("--tail--"));
+
+    buf->append(other, 2, 4);
+    EXPECT_EQ(8u, buf->get_size());
+    EXPECT_EQ(2u, buf->n_memory());
+    EXPECT_EQ(0, buf->memcmp(0, "headtail", 8));
+    EXPECT_EQ(8u, other->get_size());
+
+    buf->prepend_memory(Memory::create_wrapped(std::string(">>")));
+    EXPECT_EQ(3u, buf->n_memory());
+    EXPECT_EQ(0, buf->memcmp(0, ">>headtail", 10));
+
+    buf->remove_memory_range(1, 1);
+    EXPECT_EQ(0, buf->memcmp(0, ">>tail", 6));
+
+    buf->resize(2, 3);
+    EXPECT_EQ(3u, buf->get_size());
+    EXPECT_EQ(0, buf->memcmp(0, "tai", 3));
+
+    buf->set_size(4);
+    EXPECT_EQ(0, buf->memcmp(0, "tail", 4));
+}
+
+namespace
+{
+struct FrameStatistics
+{
+    guint64 sequence_number;
+    std::vector<int> detections;
+
+    FrameStatistics(guint64 sequence_number, std::vector<int> detections)
+    : sequence_number(sequence_number),
+      detections(std::move(detections))
+    {}
+};
+
+struct FrameLabel
+{
+    int label;
+};
+}
+
+TEST(BufferTest, CheckCustomMeta)
+{
+    Glib::RefPtr<Buffer> buf = Buffer::create(16);
+    EXPECT_FALSE(buf->get_meta<FrameStatistics>());
+
+    FrameStatistics* stats = buf->add_meta<FrameStatistics>(42u, std::vector<int>{ 1, 2, 3 });
+    ASSERT_TRUE(stats);
+    EXPECT_EQ(stats, buf->get_meta<FrameStatistics>());
+    EXPECT_NE(G_TYPE_INVALID, Meta<FrameStatistics>::get_api_type());
+
+    int n_metas = 0;
+    for (GstMeta* meta : buf->get_metas())
+    {
+        n_metas++;
+        EXPECT_EQ(stats, Meta<FrameStatistics>::get(meta));
+    }
+    EXPECT_EQ(1, n_metas);
+
+    Glib::RefPtr<Buffer> copy = buf->copy();
+    const FrameStatistics* copied = copy->get_meta<FrameStatistics>();
+    ASSERT_TRUE(copied);
+    EXPECT_NE(stats, copied);
+    EXPECT_EQ(42u, copied->sequence_number);
+    EXPECT_EQ(3u, copied->detections.size());
+
+    EXPECT_TRUE(buf->remove_meta<FrameStatistics>());
+    EXPECT_FALSE(buf->get_meta<FrameStatistics>());
+    EXPECT_FALSE(buf->remove_meta<FrameStatistics>());
+}
+
+TEST(BufferTest, CheckCustomMetaNameCollision)
+{
+    EXPECT_TRUE(Meta<FrameLabel>::register_meta("GstmmTestFrameLabel"));
+    EXPECT_FALSE(Meta<FrameLabel>::register_meta("GstmmTestFrameLabel"));
+
+    // Another type may not take the name of a registered meta.
+    struct OtherLabel
+    {
+        int label;
+    };
+    EXPECT_THROW(Meta<OtherLabel>::register_meta("GstmmTestFrameLabel"), std::runtime_error);
+}
@@ -0,0 +1,58 @@
+/*
+ * test-bufferlist.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <vector>
+
+using namespace Gst;
+using Glib::RefPtr;
+
+TEST(BufferListTest, CheckBulkInsertAndIteration)
+{
+    RefPtr<BufferList> list = BufferList::create(8);
+    ASSERT_EQ(0u, list->length());
+
+    std::vector< RefPtr<Buffer> > buffers;
+    for (guint i = 1; i <= 4; i++)
+        buffers.push_back(Buffer::create(i * 10));
+
+    list->insert(-1, buffers);
+    ASSERT_EQ(4u, list->length());
+
+    gsize total = 0;
+    guint idx = 0;
+    for (Buffer& buffer : *list)
+    {
+        EXPECT_EQ(buffers[idx]->gobj(), buffer.gobj());
+        total += buffer.get_size();
+        idx++;
+    }
+    EXPECT_EQ(100u, total);
+
+    // The list holds its own references.
+    buffers.clear();
+    EXPECT_EQ(40u, list->get(3)->get_size());
+}
+
+TEST(BufferListTest, CheckInsertInTheMiddle)
+{
+    RefPtr<BufferList> list = BufferList::create(4);
+
+    std::vector< RefPtr<Buffer> > outer;
+    outer.push_back(Buffer::create(1));
+    outer.push_back(Buffer::create(4));
+    list->insert(-1, outer);
+
+    std::vector< RefPtr<Buffer> > inner;
+    inner.push_back(Buffer::create(2));
+    inner.push_back(Buffer::create(3));
+    list->insert(1, inner);
+
+    const RefPtr<const BufferList> const_list = list;
+    gsize expected = 1;
+    for (const Buffer& buffer : *const_list)
+        EXPECT_EQ(expected++, buffer.get_size());
+    EXPECT_EQ(5u, expected);
+}
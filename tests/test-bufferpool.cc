@@ -0,0 +1,122 @@
+/*
+ * test-bufferpool.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+
+using namespace Gst;
+using Glib::RefPtr;
+
+class BufferPoolTest : public ::testing::Test
+{
+protected:
+    RefPtr<BufferPool> pool;
+
+    virtual void SetUp()
+    {
+        pool = BufferPool::create();
+
+        Structure config = pool->get_config();
+        BufferPool::config_set_params(config, Caps::create_simple("audio/x-raw"), 64, 2, 2);
+        ASSERT_TRUE(pool->set_config(config));
+    }
+};
+
+TEST_F(BufferPoolTest, CheckConfig)
+{
+    Structure config = pool->get_config();
+    RefPtr<Caps> caps;
+    guint size, min_buffers, max_buffers;
+
+    ASSERT_TRUE(BufferPool::config_get_params(config, caps, size, min_buffers, max_buffers));
+    ASSERT_TRUE(caps);
+    ASSERT_EQ(64u, size);
+    ASSERT_EQ(2u, min_buffers);
+    ASSERT_EQ(2u, max_buffers);
+}
+
+TEST_F(BufferPoolTest, CheckAcquireRequiresActivePool)
+{
+    RefPtr<Buffer> buffer;
+
+    ASSERT_EQ(FLOW_FLUSHING, pool->acquire_buffer(buffer));
+    ASSERT_FALSE(buffer);
+}
+
+TEST_F(BufferPoolTest, CheckBuffersAreRecycled)
+{
+    ASSERT_TRUE(pool->set_active(true));
+    ASSERT_TRUE(pool->is_active());
+
+    RefPtr<Buffer> buffer;
+    ASSERT_EQ(FLOW_OK, pool->acquire_buffer(buffer));
+    ASSERT_EQ(64u, buffer->get_size());
+    GstBuffer* first = buffer->gobj();
+
+    pool->release_buffer(buffer);
+    ASSERT_FALSE(buffer);
+
+    ASSERT_EQ(FLOW_OK, pool->acquire_buffer(buffer));
+    ASSERT_EQ(first, buffer->gobj());
+
+    buffer.reset();
+    ASSERT_TRUE(pool->set_active(false));
+}
+
+class CountingBufferPool : public BufferPool
+{
+public:
+    int allocated;
+
+    CountingBufferPool()
+    : allocated(0)
+    {}
+
+    FlowReturn alloc_buffer_vfunc(RefPtr<Buffer>& buffer)
+    {
+        allocated++;
+        return BufferPool::alloc_buffer_vfunc(buffer);
+    }
+};
+
+TEST(BufferPoolSubclassTest, CheckAllocBufferVfuncIsCalled)
+{
+    RefPtr<CountingBufferPool> pool(new CountingBufferPool());
+
+    Structure config = pool->get_config();
+    BufferPool::config_set_params(config, Caps::create_simple("audio/x-raw"), 32, 3, 0);
+    ASSERT_TRUE(pool->set_config(config));
+    ASSERT_TRUE(pool->set_active(true));
+
+    ASSERT_EQ(3, pool->allocated);
+
+    RefPtr<Buffer> buffer;
+    ASSERT_EQ(FLOW_OK, pool->acquire_buffer(buffer));
+    ASSERT_EQ(32u, buffer->get_size());
+
+    buffer.reset();
+    ASSERT_TRUE(pool->set_active(false));
+}
+
+class OptionBufferPool : public BufferPool
+{
+public:
+    bool set_config_vfunc(Structure& config)
+    {
+        BufferPool::config_add_option(config, "gstreamermm-test-option");
+        return BufferPool::set_config_vfunc(config);
+    }
+};
+
+TEST(BufferPoolSubclassTest, CheckSetConfigVfuncChangesConfig)
+{
+    RefPtr<OptionBufferPool> pool(new OptionBufferPool());
+
+    Structure config = pool->get_config();
+    BufferPool::config_set_params(config, Caps::create_simple("audio/x-raw"), 32, 0, 0);
+    ASSERT_FALSE(BufferPool::config_has_option(config, "gstreamermm-test-option"));
+    ASSERT_TRUE(pool->set_config(config));
+
+    ASSERT_TRUE(BufferPool::config_has_option(pool->get_config(), "gstreamermm-test-option"));
+}
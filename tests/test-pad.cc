@@ -7,6 +7,8 @@
 
 #include <gtest/gtest.h>
 #include <gstreamermm.h>
+#include <utility>
+#include <vector>
 
 using namespace Gst;
 
@@ -49,3 +51,332 @@ TEST_F(PadTest, PadCorrectCreatedUsingTemplate)
     CheckPad();
 }
 
+
+class PadFunctionsTest : public ::testing::Test
+{
+protected:
+    Glib::RefPtr<Pad> src;
+    Glib::RefPtr<Pad> sink;
+    guint received_lists;
+    guint received_buffers;
+    guint received_events;
+    gsize probed_bytes;
+    bool pull_mode_activated;
+
+    virtual void SetUp()
+    {
+        src = Pad::create("src", PAD_SRC);
+        sink = Pad::create("sink", PAD_SINK);
+        received_lists = 0;
+        received_buffers = 0;
+        received_events = 0;
+        probed_bytes = 0;
+        pull_mode_activated = false;
+    }
+
+    FlowReturn chain(const Glib::RefPtr<Pad>&, Glib::RefPtr<Buffer>&)
+    {
+        ADD_FAILURE() << "the list was unrolled";
+        return FLOW_ERROR;
+    }
+
+    FlowReturn count_buffer(const Glib::RefPtr<Pad>& pad, Glib::RefPtr<Buffer>&)
+    {
+        EXPECT_EQ(sink, pad);
+        received_buffers++;
+        return FLOW_OK;
+    }
+
+    gboolean count_event(const Glib::RefPtr<Pad>& pad, Glib::RefPtr<Event>&)
+    {
+        EXPECT_EQ(sink, pad);
+        received_events++;
+        return true;
+    }
+
+    FlowReturn write_buffer(const Glib::RefPtr<Pad>&, Glib::RefPtr<Buffer>& buffer)
+    {
+        buffer = buffer->create_writable();
+        buffer->memset(0, 0xff, buffer->get_size());
+        received_buffers++;
+        return FLOW_OK;
+    }
+
+    PadProbeReturn probe_buffer(const Glib::RefPtr<Pad>& pad, const Buffer& buffer)
+    {
+        EXPECT_EQ(src, pad);
+        probed_bytes += buffer.get_size();
+        return PAD_PROBE_OK;
+    }
+
+    FlowReturn chain_list(const Glib::RefPtr<Pad>&, Glib::RefPtr<BufferList>& list)
+    {
+        received_lists++;
+        received_buffers += list->length();
+        return FLOW_OK;
+    }
+
+    FlowReturn getrange(const Glib::RefPtr<Pad>&, guint64 offset, guint length, Glib::RefPtr<Buffer>& buffer)
+    {
+        buffer = Buffer::create(length);
+        buffer->memset(0, guint8(offset), length);
+        return FLOW_OK;
+    }
+
+    FlowReturn getrange_without_buffer(const Glib::RefPtr<Pad>&, guint64, guint, Glib::RefPtr<Buffer>&)
+    {
+        return FLOW_OK;
+    }
+
+    bool activate_sink(const Glib::RefPtr<Pad>& pad)
+    {
+        return pad->activate_mode(PAD_MODE_PULL);
+    }
+
+    bool activatemode_src(const Glib::RefPtr<Pad>&, PadMode mode, bool active)
+    {
+        pull_mode_activated = (mode == PAD_MODE_PULL && active);
+        return true;
+    }
+};
+
+TEST_F(PadFunctionsTest, CheckPushListReachesChainListFunction)
+{
+    sink->set_chain_function(sigc::mem_fun(*this, &PadFunctionsTest::chain));
+    sink->set_chain_list_function(sigc::mem_fun(*this, &PadFunctionsTest::chain_list));
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+
+    Glib::RefPtr<BufferList> list = BufferList::create(3);
+    std::vector< Glib::RefPtr<Buffer> > buffers;
+    for (int i = 0; i < 3; i++)
+        buffers.push_back(Buffer::create(8));
+    list->insert(-1, buffers);
+
+    EXPECT_EQ(FLOW_OK, src->push_list(list));
+    EXPECT_FALSE(list);
+    EXPECT_EQ(1u, received_lists);
+    EXPECT_EQ(3u, received_buffers);
+}
+
+TEST_F(PadFunctionsTest, CheckPullRangeReachesGetRangeFunction)
+{
+    src->set_activatemode_function(sigc::mem_fun(*this, &PadFunctionsTest::activatemode_src));
+    src->set_getrange_function(sigc::mem_fun(*this, &PadFunctionsTest::getrange));
+    sink->set_activate_function(sigc::mem_fun(*this, &PadFunctionsTest::activate_sink));
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    EXPECT_TRUE(pull_mode_activated);
+
+    Glib::RefPtr<Buffer> buffer;
+    ASSERT_EQ(FLOW_OK, sink->pull_range(7, 16, buffer));
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(16u, buffer->get_size());
+
+    guint8 first = 0;
+    buffer->extract(0, &first, 1);
+    EXPECT_EQ(7, first);
+}
+
+TEST_F(PadFunctionsTest, CheckPullRangeFailsWithoutBuffer)
+{
+    src->set_activatemode_function(sigc::mem_fun(*this, &PadFunctionsTest::activatemode_src));
+    src->set_getrange_function(sigc::mem_fun(*this, &PadFunctionsTest::getrange_without_buffer));
+    sink->set_activate_function(sigc::mem_fun(*this, &PadFunctionsTest::activate_sink));
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+
+    Glib::RefPtr<Buffer> buffer;
+    ASSERT_EQ(FLOW_ERROR, sink->pull_range(0, 16, buffer));
+    EXPECT_FALSE(buffer);
+}
+
+TEST_F(PadFunctionsTest, CheckCompileTimeBoundFunctions)
+{
+    sink->set_chain_function<PadFunctionsTest, &PadFunctionsTest::count_buffer>(this);
+    sink->set_event_function<PadFunctionsTest, &PadFunctionsTest::count_event>(this);
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+    EXPECT_EQ(2u, received_events);
+
+    int sink_refcount = GST_OBJECT_REFCOUNT_VALUE(sink->gobj());
+    for (int i = 0; i < 3; i++)
+    {
+        Glib::RefPtr<Buffer> buffer = Buffer::create(8);
+        EXPECT_EQ(FLOW_OK, src->push(buffer));
+    }
+    EXPECT_EQ(3u, received_buffers);
+    EXPECT_EQ(sink_refcount, GST_OBJECT_REFCOUNT_VALUE(sink->gobj()));
+}
+
+TEST_F(PadFunctionsTest, CheckPushHandsOverTheReference)
+{
+    sink->set_chain_function<PadFunctionsTest, &PadFunctionsTest::write_buffer>(this);
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+
+    Buffer::reset_writable_copy_count();
+
+    Glib::RefPtr<Buffer> buffer = Buffer::create(8);
+    EXPECT_EQ(FLOW_OK, src->push(buffer));
+    EXPECT_FALSE(buffer);
+
+    buffer = Buffer::create(8);
+    EXPECT_EQ(FLOW_OK, src->push(std::move(buffer)));
+    EXPECT_FALSE(buffer);
+
+    EXPECT_EQ(FLOW_OK, src->push(Buffer::create(8)));
+
+    buffer = Buffer::create(8);
+    EXPECT_EQ(FLOW_OK, sink->chain(std::move(buffer)));
+    EXPECT_FALSE(buffer);
+
+    EXPECT_EQ(4u, received_buffers);
+    EXPECT_EQ(0u, Buffer::get_writable_copy_count());
+
+    // A reference kept by the caller forces a copy.
+    buffer = Buffer::create(8);
+    Glib::RefPtr<Buffer> kept = buffer;
+    EXPECT_EQ(FLOW_OK, src->push(std::move(buffer)));
+    EXPECT_EQ(1u, Buffer::get_writable_copy_count());
+}
+
+TEST_F(PadFunctionsTest, CheckBufferProbeBorrowsBuffers)
+{
+    sink->set_chain_function<PadFunctionsTest, &PadFunctionsTest::count_buffer>(this);
+    gulong id = src->add_buffer_probe(sigc::mem_fun(*this, &PadFunctionsTest::probe_buffer));
+    EXPECT_NE(0u, id);
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+
+    int src_refcount = GST_OBJECT_REFCOUNT_VALUE(src->gobj());
+    for (gsize size = 1; size <= 4; size++)
+    {
+        Glib::RefPtr<Buffer> buffer = Buffer::create(size);
+        EXPECT_EQ(FLOW_OK, src->push(buffer));
+    }
+    EXPECT_EQ(10u, probed_bytes);
+    EXPECT_EQ(4u, received_buffers);
+    EXPECT_EQ(src_refcount, GST_OBJECT_REFCOUNT_VALUE(src->gobj()));
+
+    src->remove_probe(id);
+    Glib::RefPtr<Buffer> buffer = Buffer::create(8);
+    EXPECT_EQ(FLOW_OK, src->push(buffer));
+    EXPECT_EQ(10u, probed_bytes);
+}
+
+TEST_F(PadFunctionsTest, CheckStatistics)
+{
+    EXPECT_FALSE(sink->has_statistics());
+    sink->enable_statistics();
+    src->enable_statistics();
+    EXPECT_TRUE(sink->has_statistics());
+
+    // The statistics do not depend on the pad functions.
+    sink->set_chain_function<PadFunctionsTest, &PadFunctionsTest::count_buffer>(this);
+
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+
+    for (int i = 0; i < 3; i++)
+    {
+        Glib::RefPtr<Buffer> buffer = Buffer::create(16);
+        buffer->set_pts(i * SECOND);
+        EXPECT_EQ(FLOW_OK, src->push(buffer));
+    }
+
+    PadStatistics statistics = sink->get_statistics();
+    EXPECT_EQ(sink, statistics.pad);
+    EXPECT_EQ(3u, statistics.buffers);
+    EXPECT_EQ(48u, statistics.bytes);
+    EXPECT_EQ(0u, statistics.chain_calls);
+    EXPECT_EQ(2 * SECOND, statistics.last_pts);
+    EXPECT_EQ(2 * SECOND, statistics.last_running_time);
+    EXPECT_EQ(3u, received_buffers);
+
+    // The pushes are measured on the source pad.
+    statistics = src->get_statistics();
+    EXPECT_EQ(3u, statistics.buffers);
+    EXPECT_EQ(3u, statistics.chain_calls);
+    EXPECT_LE(statistics.max_chain_time, statistics.chain_time);
+    EXPECT_EQ(3u, statistics.flow_returns[FLOW_OK]);
+    EXPECT_EQ(1u, statistics.flow_returns.size());
+    EXPECT_FALSE(gst_pad_is_blocked(src->gobj()));
+
+    src->disable_statistics();
+    sink->disable_statistics();
+    Glib::RefPtr<Buffer> buffer = Buffer::create(16);
+    EXPECT_EQ(FLOW_OK, src->push(buffer));
+    EXPECT_EQ(4u, received_buffers);
+    EXPECT_EQ(3u, sink->get_statistics().buffers);
+
+    sink->reset_statistics();
+    EXPECT_EQ(0u, sink->get_statistics().buffers);
+}
+
+TEST_F(PadFunctionsTest, CheckStatisticsOfCPushes)
+{
+    sink->set_chain_function<PadFunctionsTest, &PadFunctionsTest::count_buffer>(this);
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+    src->push_event(EventStreamStart::create("stream"));
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventNewSegment::create(segment));
+
+    src->enable_statistics();
+    src->enable_statistics();
+
+    // The flow return of a push that bypasses Gst::Pad::push() is counted
+    // when the next buffer is pushed.
+    EXPECT_EQ(GST_FLOW_OK, gst_pad_push(src->gobj(), gst_buffer_new_allocate(0, 16, 0)));
+    EXPECT_EQ(0u, src->get_statistics().chain_calls);
+    EXPECT_EQ(GST_FLOW_OK, gst_pad_push(src->gobj(), gst_buffer_new_allocate(0, 16, 0)));
+    EXPECT_EQ(1u, src->get_statistics().chain_calls);
+
+    src->disable_statistics();
+    src->disable_statistics();
+    PadStatistics statistics = src->get_statistics();
+    EXPECT_EQ(2u, statistics.buffers);
+    EXPECT_EQ(2u, statistics.chain_calls);
+    EXPECT_EQ(2u, statistics.flow_returns[FLOW_OK]);
+    EXPECT_EQ(0u, statistics.chain_time);
+    EXPECT_EQ(2u, received_buffers);
+}
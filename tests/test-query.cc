@@ -57,3 +57,46 @@ TEST(QueryTest, CorrectCreatingQueryConvert)
     CreatingQueryTest<QueryConvert>(
             std::bind(&QueryConvert::create, FORMAT_PERCENT, 10, FORMAT_BYTES), QUERY_CONVERT);
 }
+
+TEST(QueryTest, CheckQueryAllocationPools)
+{
+    RefPtr<Caps> caps = Caps::create_simple("video/x-raw");
+    RefPtr<QueryAllocation> query = QueryAllocation::create(caps, true);
+
+    ASSERT_TRUE(query);
+    ASSERT_EQ(QUERY_ALLOCATION, query->get_query_type());
+
+    RefPtr<Caps> parsed_caps;
+    bool need_pool = false;
+    query->parse(parsed_caps, need_pool);
+    ASSERT_TRUE(parsed_caps);
+    ASSERT_TRUE(need_pool);
+
+    RefPtr<BufferPool> pool = BufferPool::create();
+    query->add_allocation_pool(pool, 1024, 2, 0);
+    ASSERT_EQ(1u, query->get_n_allocation_pools());
+
+    RefPtr<BufferPool> parsed_pool;
+    guint size, min_buffers, max_buffers;
+    query->parse_nth_allocation_pool(0, parsed_pool, size, min_buffers, max_buffers);
+    ASSERT_EQ(pool, parsed_pool);
+    ASSERT_EQ(1024u, size);
+    ASSERT_EQ(2u, min_buffers);
+    ASSERT_EQ(0u, max_buffers);
+}
+
+TEST(QueryTest, CheckQueryAllocationParams)
+{
+    RefPtr<QueryAllocation> query = QueryAllocation::create(Caps::create_simple("video/x-raw"), false);
+    RefPtr<Allocator> allocator = AlignedAllocator::create();
+
+    query->add_allocation_param(allocator, AllocationParams(MemoryFlags(0), 63, 0, 32));
+    ASSERT_EQ(1u, query->get_n_allocation_params());
+
+    RefPtr<Allocator> parsed_allocator;
+    AllocationParams params;
+    query->parse_nth_allocation_param(0, parsed_allocator, params);
+    ASSERT_EQ(allocator, parsed_allocator);
+    ASSERT_EQ(63u, params.get_align());
+    ASSERT_EQ(32u, params.get_padding());
+}
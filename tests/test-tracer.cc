@@ -0,0 +1,111 @@
+/*
+ * test-tracer.cc
+ *
+ * The hooks of a tracer cannot be removed, so the tracer tests run in their
+ * own program.
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <gstreamermm/private/tracer_p.h>
+
+using namespace Gst;
+
+class CountingTracer : public Tracer
+{
+public:
+    guint pushed_buffers;
+    guint pushed_events;
+    FlowReturn last_result;
+    GstPad* last_pad;
+
+    explicit CountingTracer(GstTracer* gobj)
+    : Tracer(gobj),
+      pushed_buffers(0),
+      pushed_events(0),
+      last_result(FLOW_ERROR),
+      last_pad(0)
+    {
+        register_hook(TRACER_HOOK_PAD_PUSH_PRE);
+        register_hook(TRACER_HOOK_PAD_PUSH_POST);
+        register_hook(TRACER_HOOK_PAD_PUSH_EVENT_PRE);
+    }
+
+protected:
+    virtual void pad_push_pre_vfunc(ClockTime, GstPad* pad, Buffer&)
+    {
+        pushed_buffers++;
+        last_pad = pad;
+    }
+
+    virtual void pad_push_post_vfunc(ClockTime, GstPad*, FlowReturn result)
+    {
+        last_result = result;
+    }
+
+    virtual void pad_push_event_pre_vfunc(ClockTime, GstPad*, Event&)
+    {
+        pushed_events++;
+    }
+};
+
+GstFlowReturn drop_buffer(GstPad*, GstObject*, GstBuffer* buffer)
+{
+    gst_buffer_unref(buffer);
+    return GST_FLOW_OK;
+}
+
+class TracerTest : public ::testing::Test
+{
+protected:
+    FlowReturn chain(const Glib::RefPtr<Pad>&, Glib::RefPtr<Buffer>&)
+    {
+        return FLOW_OK;
+    }
+};
+
+TEST_F(TracerTest, CheckHooksAreCalled)
+{
+    Glib::RefPtr<Tracer> tracer = Tracer::create(register_mm_tracer<CountingTracer>("gstmmcountingtracer"));
+    ASSERT_TRUE(tracer);
+    CountingTracer* counting_tracer = dynamic_cast<CountingTracer*>(tracer.operator->());
+    ASSERT_TRUE(counting_tracer);
+
+    Glib::RefPtr<Pad> src = Pad::create("src", PAD_SRC);
+    Glib::RefPtr<Pad> sink = Pad::create("sink", PAD_SINK);
+    sink->set_chain_function(sigc::mem_fun(*this, &TracerTest::chain));
+    ASSERT_EQ(PAD_LINK_OK, src->link(sink));
+    ASSERT_TRUE(sink->set_active(true));
+    ASSERT_TRUE(src->set_active(true));
+
+    Segment segment;
+    segment.init(FORMAT_TIME);
+    src->push_event(EventStreamStart::create("stream"));
+    src->push_event(EventNewSegment::create(segment));
+    EXPECT_EQ(2u, counting_tracer->pushed_events);
+
+    for (int i = 0; i < 3; i++)
+    {
+        Glib::RefPtr<Buffer> buffer = Buffer::create(8);
+        EXPECT_EQ(FLOW_OK, src->push(buffer));
+    }
+    EXPECT_EQ(3u, counting_tracer->pushed_buffers);
+    EXPECT_EQ(FLOW_OK, counting_tracer->last_result);
+    EXPECT_EQ(src->gobj(), counting_tracer->last_pad);
+
+    // The hooks do not create wrappers for the pads they are given.
+    GstPad* c_src = GST_PAD(gst_object_ref_sink(gst_pad_new("src", GST_PAD_SRC)));
+    GstPad* c_sink = GST_PAD(gst_object_ref_sink(gst_pad_new("sink", GST_PAD_SINK)));
+    gst_pad_set_chain_function(c_sink, &drop_buffer);
+    ASSERT_EQ(GST_PAD_LINK_OK, gst_pad_link(c_src, c_sink));
+    gst_pad_set_active(c_sink, TRUE);
+    gst_pad_set_active(c_src, TRUE);
+    gst_pad_push_event(c_src, gst_event_new_stream_start("stream"));
+    gst_pad_push_event(c_src, gst_event_new_segment(segment.gobj()));
+    EXPECT_EQ(GST_FLOW_OK, gst_pad_push(c_src, gst_buffer_new()));
+    EXPECT_EQ(4u, counting_tracer->pushed_buffers);
+    EXPECT_EQ(c_src, counting_tracer->last_pad);
+    EXPECT_EQ(0, Glib::ObjectBase::_get_current_wrapper(G_OBJECT(c_src)));
+    gst_object_unref(c_src);
+    gst_object_unref(c_sink);
+}
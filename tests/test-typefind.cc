@@ -0,0 +1,73 @@
+/*
+ * test-typefind.cc
+ */
+
+#include <gtest/gtest.h>
+#include <gstreamermm.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <glib/gstdio.h>
+#include <string>
+#include <vector>
+
+using namespace Gst;
+
+class TypeFindTest : public ::testing::Test
+{
+protected:
+    std::vector<std::string> filenames;
+
+    virtual void TearDown()
+    {
+        for (std::vector<std::string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+            g_unlink(it->c_str());
+    }
+
+    void create_file(const std::string& name, const std::string& contents)
+    {
+        const std::string filename = Glib::build_filename(Glib::get_tmp_dir(), name);
+        Glib::file_set_contents(filename, contents);
+        filenames.push_back(filename);
+    }
+};
+
+TEST_F(TypeFindTest, DetectFilesInParallel)
+{
+    const std::string png("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+
+    for (int i = 0; i < 8; i++)
+    {
+        const std::string index = std::to_string(i);
+        create_file("gstreamermm-typefind-" + index + ".png", png);
+        create_file("gstreamermm-typefind-" + index + ".empty", std::string());
+    }
+
+    std::vector<TypeFind::Detection> detections = TypeFind::detect(filenames, 4);
+    ASSERT_EQ(filenames.size(), detections.size());
+
+    for (std::size_t i = 0; i < detections.size(); i++)
+    {
+        ASSERT_EQ(filenames[i], detections[i].filename);
+
+        if (i % 2)
+        {
+            ASSERT_FALSE(detections[i].caps);
+            ASSERT_EQ(TYPE_FIND_NONE, detections[i].probability);
+        }
+        else
+        {
+            ASSERT_TRUE(detections[i].caps);
+            ASSERT_STREQ("image/png", detections[i].caps->get_structure(0).get_name().c_str());
+            ASSERT_EQ(TYPE_FIND_MAXIMUM, detections[i].probability);
+        }
+    }
+}
+
+TEST_F(TypeFindTest, DetectMissingFile)
+{
+    std::vector<std::string> missing(1, Glib::build_filename(Glib::get_tmp_dir(), "gstreamermm-typefind-missing"));
+
+    std::vector<TypeFind::Detection> detections = TypeFind::detect(missing);
+    ASSERT_EQ(1u, detections.size());
+    ASSERT_FALSE(detections[0].caps);
+}
@@ -27,6 +27,7 @@ _CONV_ENUM(Gst,IndexLookupMethod)
 _CONV_ENUM(Gst,IndexResolverMethod)
 _CONV_ENUM(Gst,LockFlags)
 _CONV_ENUM(Gst,MapFlags)
+_CONV_ENUM(Gst,MemoryFlags)
 _CONV_ENUM(Gst,MessageType)
 _CONV_ENUM(Gst,MixerFlags)
 _CONV_ENUM(Gst,MixerType)
@@ -60,6 +61,10 @@ _CONV_GLIB_ENUM(ThreadPriority)
 
 dnl ############### gstreamermm Class Conversions ######################
 
+dnl Allocator
+_CONVERSION(`GstAllocator*',`Glib::RefPtr<Gst::Allocator>',`Glib::wrap($3)')
+_CONVERSION(`const Glib::RefPtr<Gst::Allocator>&',`GstAllocator*', `Glib::unwrap($3)')
+
 dnl Buffer
 _CONVERSION(`GstBuffer*',`Glib::RefPtr<Gst::Buffer>',`Glib::wrap($3)')
 _CONVERSION(`const Glib::RefPtr<Gst::Buffer>&',`GstBuffer*', `Glib::unwrap($3)')
@@ -72,6 +77,10 @@ _CONVERSION(`Glib::RefPtr<Gst::BufferList>',`GstBufferList*', `Glib::unwrap($3)'
 _CONVERSION(`GstBufferList*', `Glib::RefPtr<Gst::BufferList>', `Glib::wrap($3)')
 _CONVERSION(`const Glib::RefPtr<Gst::BufferList>&', `GstBufferList*', `Glib::unwrap($3)')
 
+dnl BufferPool
+_CONVERSION(`GstBufferPool*',`Glib::RefPtr<Gst::BufferPool>',`Glib::wrap($3)')
+_CONVERSION(`const Glib::RefPtr<Gst::BufferPool>&',`GstBufferPool*', `Glib::unwrap($3)')
+
 dnl Bus
 _CONVERSION(`const Glib::RefPtr<Gst::Bus>&',`GstBus*', `Glib::unwrap($3)')
 _CONVERSION(`GstBus*',`Glib::RefPtr<Gst::Bus>',`Glib::wrap($3)')
@@ -267,6 +276,7 @@ _CONVERSION(`guint64&',`guint64*',`&$3')
 _CONVERSION(`guint*',`guint&',`*$3')
 _CONVERSION(`const guint&',`guint',`$3')
 _CONVERSION(`gsize*',`gsize&',`*$3')
+_CONVERSION(`gsize&',`gsize*',`&$3')
 _CONVERSION(`const guint32&',`guint32',`$3')
 _CONVERSION(`guint8*&',`guint8**',`&$3')
 